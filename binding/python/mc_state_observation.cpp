@@ -0,0 +1,129 @@
+/**
+ * \file      mc_state_observation.cpp
+ * \brief      Python bindings of the batch processing of the observers.
+ *
+ * \details
+ * Exposes the headless controller and observers (headlessTools.h) and their batch processing (batchTools.h) to the
+ * offline analysis and learning pipelines. The measurements are given as float64 NumPy arrays of shape
+ * (rows, iterations) in Fortran order, which are viewed without copy (the transpose of a C-ordered array of shape
+ * (iterations, rows) has this layout). The estimated kinematics are returned in arrays with the same layout, written
+ * directly by the observer. The GIL is released during the processing, so several sequences can be processed in
+ * parallel threads, each with its own controller.
+ *
+ *    import mc_state_observation as mcso
+ *    ctl = mcso.Controller(["JVRC1"], 0.005)
+ *    ko = mcso.MCKineticsObserver(ctl, open("MCKineticsObserver.yaml").read())
+ *    out = ko.run_batch(encoders.T, gyrometers.T, accelerometers.T, wrenches.T)
+ *    positions = out["positions"].T
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_state_observation/MCKineticsObserver.h>
+#include <mc_state_observation/observersTools/batchTools.h>
+#include <mc_state_observation/observersTools/headlessTools.h>
+#ifdef MCSO_PYTHON_WITH_ODOMETRY
+#  include <mc_state_observation/NaiveOdometry.h>
+#  include <mc_state_observation/TiltObserver.h>
+#endif
+
+#include <pybind11/eigen.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+namespace mcso = mc_state_observation;
+
+namespace
+{
+
+using ConstMatrixRef = Eigen::Ref<const Eigen::MatrixXd>;
+
+/// Controller providing the robots, the datastore and the time step to the headless observers of a sequence.
+struct Controller
+{
+  Controller(const std::vector<std::string> & robotModule, double dt)
+  : ctl(mcso::headlessTools::makeController(mc_rbdyn::RobotLoader::get_robot_module(robotModule), dt))
+  {
+  }
+
+  std::unique_ptr<mc_control::MCController> ctl;
+};
+
+/// Headless observer, bound to the controller it was created with.
+template<typename ObserverT>
+struct Observer
+{
+  Observer(Controller & controller, const std::string & config, const std::string & type)
+  : controller(controller),
+    observer(mcso::headlessTools::makeObserver<ObserverT>(*controller.ctl, type,
+                                                          mc_rtc::Configuration::fromYAMLData(config)))
+  {
+  }
+
+  py::dict runBatch(const ConstMatrixRef & encoders,
+                    const ConstMatrixRef & gyrometers,
+                    const ConstMatrixRef & accelerometers,
+                    const ConstMatrixRef & wrenches,
+                    const ConstMatrixRef & encoderVelocities)
+  {
+    const auto nbIters = static_cast<py::ssize_t>(encoders.cols());
+    py::array_t<double, py::array::f_style> positions({py::ssize_t(3), nbIters});
+    py::array_t<double, py::array::f_style> orientations({py::ssize_t(4), nbIters});
+    py::array_t<double, py::array::f_style> linVels({py::ssize_t(3), nbIters});
+    py::array_t<double, py::array::f_style> angVels({py::ssize_t(3), nbIters});
+
+    mcso::batchTools::InputView inputs(encoders, encoderVelocities, gyrometers, accelerometers, wrenches);
+    // the observer writes directly in the returned arrays
+    Eigen::Map<Eigen::MatrixXd> positionsMap(positions.mutable_data(), 3, nbIters);
+    Eigen::Map<Eigen::MatrixXd> orientationsMap(orientations.mutable_data(), 4, nbIters);
+    Eigen::Map<Eigen::MatrixXd> linVelsMap(linVels.mutable_data(), 3, nbIters);
+    Eigen::Map<Eigen::MatrixXd> angVelsMap(angVels.mutable_data(), 3, nbIters);
+    mcso::batchTools::OutputView outputs(positionsMap, orientationsMap, linVelsMap, angVelsMap);
+    {
+      py::gil_scoped_release release;
+      observer->runBatch(*controller.ctl, inputs, outputs);
+    }
+
+    py::dict estimation;
+    estimation["positions"] = positions;
+    estimation["orientations"] = orientations;
+    estimation["lin_vels"] = linVels;
+    estimation["ang_vels"] = angVels;
+    return estimation;
+  }
+
+  Controller & controller;
+  std::unique_ptr<ObserverT> observer;
+};
+
+template<typename ObserverT>
+void bindObserver(py::module_ & m, const char * name)
+{
+  py::class_<Observer<ObserverT>>(m, name)
+      .def(py::init<Controller &, const std::string &, const std::string &>(), py::arg("controller"),
+           py::arg("config"), py::arg("type") = name, py::keep_alive<1, 2>(),
+           "Creates a headless observer from its YAML configuration")
+      .def("run_batch", &Observer<ObserverT>::runBatch, py::arg("encoders").noconvert(),
+           py::arg("gyrometers").noconvert(), py::arg("accelerometers").noconvert(), py::arg("wrenches").noconvert(),
+           py::arg("encoder_velocities").noconvert() = Eigen::MatrixXd(),
+           "Runs the observer on a recorded sequence (arrays of shape (rows, iterations) in Fortran order, see "
+           "batchTools.h for the rows) and returns the estimated kinematics of the floating base in the world");
+}
+
+} // namespace
+
+PYBIND11_MODULE(mc_state_observation, m)
+{
+  m.doc() = "Batch processing of recorded sequences by the mc_state_observation observers";
+
+  py::class_<Controller>(m, "Controller")
+      .def(py::init<const std::vector<std::string> &, double>(), py::arg("robot_module"), py::arg("dt"),
+           "Creates a controller for the headless observers from the robot module (name and parameters as given to "
+           "mc_rtc's RobotLoader) and the time step");
+
+  bindObserver<mcso::MCKineticsObserver>(m, "MCKineticsObserver");
+#ifdef MCSO_PYTHON_WITH_ODOMETRY
+  bindObserver<mcso::TiltObserver>(m, "TiltObserver");
+  bindObserver<mcso::NaiveOdometry>(m, "NaiveOdometry");
+#endif
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mc_observers/Observer.h>
+#include <mc_state_observation/observersTools/goldenTools.h>
 
 #include <state-observation/dynamical-system/imu-dynamical-system.hpp>
 #include <state-observation/observer/extended-kalman-filter.hpp>
@@ -97,6 +98,8 @@ protected:
   stateObservation::Matrix3 Kpo_, Kdo_;
 
   Eigen::Matrix3d m_orientation = Eigen::Matrix3d::Identity(); ///< Result
+
+  goldenTools::GoldenTrajectory golden_; ///< Comparison of the estimation to a golden trajectory
 };
 
 } // namespace mc_state_observation
@@ -5,7 +5,19 @@
 #include <mc_rbdyn/Contact.h>
 #include <mc_rbdyn/Robot.h>
 #include <boost/circular_buffer.hpp>
+#include <mc_state_observation/observersTools/asyncTools.h>
+#include <mc_state_observation/observersTools/batchTools.h>
+#include <mc_state_observation/observersTools/flightRecorder.h>
+#include <mc_state_observation/observersTools/forceSensorsCache.h>
 #include <mc_state_observation/observersTools/measurementsTools.h>
+#include <mc_state_observation/observersTools/goldenTools.h>
+#include <mc_state_observation/observersTools/heightmap.h>
+#include <mc_state_observation/observersTools/imuPropagation.h>
+#include <mc_state_observation/observersTools/kinematicsTools.h>
+#include <mc_state_observation/observersTools/memoryTools.h>
+#include <mc_state_observation/observersTools/perfCounters.h>
+#include <mc_state_observation/observersTools/standstillTools.h>
+#include <mc_state_observation/observersTools/traceTools.h>
 #include <state-observation/dynamics-estimators/kinetics-observer.hpp>
 
 #include <mc_observers/Observer.h>
@@ -23,6 +35,39 @@ namespace mc_state_observation
  *will recover the last ellapsed second (or less) using the displacement made by the Tilt Observer.
  **/
 
+/// @brief Visco-elastic model of the flexibility of a contact.
+/// @details The compliances (inverse of the stiffnesses) are computed once when the model is set, as they are required
+/// at every iteration to compute the rest pose of the contact.
+struct ContactViscoElasticModel
+{
+  /// @brief Sets the parameters of the model and computes the associated compliances.
+  void set(const stateObservation::Matrix3 & linStiffness,
+           const stateObservation::Matrix3 & linDamping,
+           const stateObservation::Matrix3 & angStiffness,
+           const stateObservation::Matrix3 & angDamping)
+  {
+    linStiffness_ = linStiffness;
+    linDamping_ = linDamping;
+    angStiffness_ = angStiffness;
+    angDamping_ = angDamping;
+    linCompliance_ = linStiffness.inverse();
+    angCompliance_ = angStiffness.inverse();
+  }
+
+  // linear stiffness of the contact
+  stateObservation::Matrix3 linStiffness_ = stateObservation::Matrix3::Zero();
+  // linear damping of the contact
+  stateObservation::Matrix3 linDamping_ = stateObservation::Matrix3::Zero();
+  // angular stiffness of the contact
+  stateObservation::Matrix3 angStiffness_ = stateObservation::Matrix3::Zero();
+  // angular damping of the contact
+  stateObservation::Matrix3 angDamping_ = stateObservation::Matrix3::Zero();
+  // inverse of the linear stiffness
+  stateObservation::Matrix3 linCompliance_ = stateObservation::Matrix3::Zero();
+  // inverse of the angular stiffness
+  stateObservation::Matrix3 angCompliance_ = stateObservation::Matrix3::Zero();
+};
+
 /// @brief Class containing the information of a contact.
 /// @details This class is an enhancement of the ContactWithSensor class with the kinematics of the contact in the
 /// floating base and the kinematics of the frame of the sensor in the frame of the contact surface
@@ -61,6 +106,14 @@ public:
   stateObservation::kine::Kinematics fbContactKine_;
   // kinematics of the sensor frame in the frame of the contact surface
   stateObservation::kine::Kinematics surfaceSensorKine_;
+  // visco-elastic model of the contact, set when the contact is added to the Kinetics Observer
+  ContactViscoElasticModel viscoElasticModel_;
+  // index of the parent body of the force sensor in the robot, -1 until computed
+  int sensorParentIndex_ = -1;
+  // kinematics of the force sensor in its parent body, computed with sensorParentIndex_
+  kinematicsTools::PoseVelKinematics parentSensorKine_;
+  // indicates if the contact was prepared before its touchdown: visco-elastic model selected and log entries added
+  bool prewarmed_ = false;
 };
 
 struct MCKineticsObserver : public mc_observers::Observer
@@ -76,9 +129,26 @@ struct MCKineticsObserver : public mc_observers::Observer
 
   void update(mc_control::MCController & ctl) override;
 
+  /// @brief Runs the observer on a recorded sequence, see batchTools.h. The observer must be headless.
+  /// @param ctl Controller whose robots receive the recorded measurements
+  /// @param inputs Recorded measurements, one column per iteration
+  /// @param outputs Estimated kinematics of the floating base, preallocated with the size of the sequence
+  void runBatch(mc_control::MCController & ctl,
+                const batchTools::InputView & inputs,
+                batchTools::OutputView outputs);
+
 protected:
+  /// @brief Body of run(), enclosed in the trace scope of the iteration.
+  /// @param ctl Controller.
+  bool runIteration(const mc_control::MCController & ctl);
   /// @brief sets all the covariances required by the Kinetics Observer
   void setObserverCovariances();
+  /// @brief Sets the sampling time and the process covariance of the Kinetics Observer for a prediction covering the
+  /// given number of iterations.
+  /// @details The process noise is a random walk, so its covariance grows linearly with the duration of the prediction.
+  /// Must be set back to 1 before adding contacts, whose process covariance is the one of a single iteration.
+  /// @param nbIters Number of iterations covered by the next update of the Kinetics Observer.
+  void setPredictionIterations(int nbIters);
   /// @brief Update the pose and velocities of the robot in the world frame. Used only to update the ones of the robot
   /// used for the visualization of the estimation made by the Kinetics Observer.
   /// @param robot The robot to update.
@@ -90,24 +160,16 @@ protected:
 
   /// @brief Sums up the wrenches measured by the unused force sensors expressed in the centroid frame to give them as
   /// an input to the Kinetics Observer
-  /// @param inputRobot A robot whose configuration is the one of real robot, but whose pose, velocities and
-  /// accelerations are set to zero in the control frame. Allows to ease computations performed in the local frame of
-  /// the robot.
-  /// @param measRobot The control robot. Used to retrieve the measurements.
-  void inputAdditionalWrench(const mc_rbdyn::Robot & inputRobot, const mc_rbdyn::Robot & measRobot);
+  /// @details The measurements are retrieved from inputForceSensors_, which must be updated beforehand.
+  void inputAdditionalWrench();
 
   /// @brief Adds the measurement of the desired sensors to the external force given as an input to the Kinetics
   /// Observer
-  /// @details The force sensors must be given with the list forceSensorsAsInput_
-  /// @param inputRobot A robot whose configuration is the one of real robot, but whose pose, velocities and
-  /// accelerations are set to zero in the control frame. Allows to ease computations performed in the local frame of
-  /// the robot.
-  /// @param measRobot The control robot. Used to retrieve the measurements.
+  /// @details The force sensors must be given with the list forceSensorsAsInput_. The measurements are retrieved from
+  /// inputForceSensors_, which must be updated beforehand.
   /// @param inputAddtionalForce the external force given as input
   /// @param inputAddtionalTorque the external torque given as input
-  void addSensorsAsInputs(const mc_rbdyn::Robot & inputRobot,
-                          const mc_rbdyn::Robot & measRobot,
-                          stateObservation::Vector3 & inputAddtionalForce,
+  void addSensorsAsInputs(stateObservation::Vector3 & inputAddtionalForce,
                           stateObservation::Vector3 & inputAddtionalTorque);
 
   /// @brief Update the IMUs, including the measurements, measurement covariances and kinematics in the floating
@@ -118,6 +180,97 @@ protected:
   /// the robot.
   void updateIMUs(const mc_rbdyn::Robot & measRobot, const mc_rbdyn::Robot & inputRobot);
 
+  /// @brief Computes the kinematics of an IMU in the floating base's frame (pose, velocities and accelerations).
+  /// @param inputRobot A robot whose configuration is the one of real robot, but whose floating base is at the origin.
+  /// @param imuName Name of the IMU.
+  stateObservation::kine::Kinematics imuKinematics(const mc_rbdyn::Robot & inputRobot, const std::string & imuName);
+
+  /// @brief Gathers the measurements of the first IMU used to propagate the estimation on the iterations on which the
+  /// Kinetics Observer is not updated.
+  /// @param measRobot The control robot. Used to retrieve the measurements.
+  /// @param inputRobot A robot whose configuration is the one of real robot, but whose floating base is at the origin.
+  /// @param dt Duration of the iteration.
+  imuPropagation::ImuSample imuSample(const mc_rbdyn::Robot & measRobot,
+                                      const mc_rbdyn::Robot & inputRobot,
+                                      double dt);
+
+  /// @brief Keeps an IMU sample until the result of the running asynchronous update is available. If the buffer is
+  /// full, its two oldest samples are merged into a single propagation step.
+  /// @param sample The IMU sample of the current iteration.
+  void pushAsyncImuSample(const imuPropagation::ImuSample & sample);
+
+  /// @brief Indicates if the accelerometer is used to propagate the estimation between two updates of the Kinetics
+  /// Observer. When only throttled during the standstill, the linear velocity is kept constant.
+  inline bool propagationWithAccelerometer() const noexcept
+  {
+    return (multiRatePeriod_ > 1 || async_) && propagationWithAccelerometer_;
+  }
+
+  /// @brief Sets the estimated pose, velocity and acceleration of the floating base in the world.
+  /// @param mcko_K_0_fb Kinematics of the floating base in the world.
+  void publishEstimation(const stateObservation::kine::Kinematics & mcko_K_0_fb);
+
+  /// @brief Copies the configuration of the real robot into the input robot and brings its floating base back to the
+  /// origin of the world with zero velocities and accelerations.
+  void updateInputRobot(const mc_rbdyn::Robot & realRobot, mc_rbdyn::Robot & inputRobot);
+
+  /// @brief Gives the inputs and measurements of the current iteration to the Kinetics Observer (center of mass,
+  /// contacts, additional wrench, IMUs and inertia).
+  /// @param ctl Controller.
+  /// @param robot The control robot.
+  /// @param inputRobot A robot whose configuration is the one of real robot, but whose floating base is at the origin.
+  /// @param logger Logger, receiving the entries of the new contacts.
+  void setInputs(const mc_control::MCController & ctl,
+                 const mc_rbdyn::Robot & robot,
+                 const mc_rbdyn::Robot & inputRobot,
+                 mc_rtc::Logger & logger);
+
+  /// @brief Handles the result of an update of the Kinetics Observer: estimation of the floating base if no anomaly is
+  /// detected, backup by the Tilt Observer otherwise.
+  /// @param ctl Controller.
+  /// @param robot The control robot.
+  /// @param inputRobot A robot whose configuration is the one of real robot, but whose floating base is at the origin.
+  /// Its floating base is moved by the recovery after an anomaly.
+  /// @param logger Logger.
+  void processResult(const mc_control::MCController & ctl,
+                     const mc_rbdyn::Robot & robot,
+                     mc_rbdyn::Robot & inputRobot,
+                     mc_rtc::Logger & logger);
+
+  /// @brief Predicts the estimation given by an asynchronous update forward to the current iteration with the IMU
+  /// measurements received since the update was started.
+  void forwardPredict();
+
+  /// @brief Applies the anomaly simulation requested from the gui.
+  void applySimulatedNan();
+
+  /// @brief Updates the robot used for the visualization and the per-iteration diagnostics at the end of run().
+  /// @param ctl Controller.
+  void finishIteration(const mc_control::MCController & ctl);
+
+  /// @brief Declares the components of the observer in the memory report.
+  void initMemoryReport();
+
+  /// @brief Initializes the flight recorder, which keeps the last seconds of inputs, state and state covariance in
+  /// memory so they can be dumped to a file when an anomaly occurs.
+  /// @param duration Duration (in s) covered by the recorder.
+  /// @param directory Directory in which the records are dumped.
+  /// @param dt Timestep of the controller.
+  /// @param threadConfig Placement and scheduling of the thread in charge of the dumps.
+  void initFlightRecorder(double duration,
+                          const std::string & directory,
+                          double dt,
+                          const threadTools::ThreadConfiguration & threadConfig);
+
+  /// @brief Captures the inputs given to the Kinetics Observer for its next update, to be recorded with its result.
+  /// @param measRobot The control robot. Used to retrieve the measurements.
+  /// @param t Current time.
+  void captureFlightInputs(const mc_rbdyn::Robot & measRobot, double t);
+
+  /// @brief Copies the inputs captured for the last update of the Kinetics Observer, its state and the diagonal of its
+  /// state covariance into the flight recorder.
+  void recordFlight();
+
   /*! \brief Add observer from logger
    *
    * @param category Category in which to log this observer
@@ -190,6 +343,15 @@ protected:
                                                                               const mc_rbdyn::ForceSensor & fs,
                                                                               const sva::ForceVecd & measuredWrench);
 
+  /// @brief Computes the kinematics of the force sensor of the contact in the world frame. The pose of the sensor in
+  /// its parent body is computed on the first call and kept in the contact.
+  /// @param contact Contact whose sensor we want the kinematics of
+  /// @param robot robot the contacts belong to
+  /// @param fs force sensor
+  stateObservation::kine::Kinematics worldSensorKinematics(KoContactWithSensor & contact,
+                                                           const mc_rbdyn::Robot & robot,
+                                                           const mc_rbdyn::ForceSensor & fs);
+
   /// @brief Computes the kinematics of the contact attached to the robot in the world frame.
   /// @param contact Contact of which we want to compute the kinematics
   /// @param robot robot the contacts belong to
@@ -209,13 +371,54 @@ protected:
                                      stateObservation::kine::Kinematics surfaceSensorKine,
                                      const sva::ForceVecd & measuredWrench);
 
-  /// @brief Updates the measurements of the force sensor attached to a contact.
-  /// @details Expresses the measured wrench in the frame of the contact, as the sensor is not necessarily attached to
-  /// it.
+  /// @brief Updates the measurements of the force sensor attached to a contact whose frame is the one of the sensor.
+  /// @details Used when the contacts are detected by thresholding the measured force.
+  /// @param contact Contact associated to the sensor
+  /// @param measuredWrench measured wrench
+  void updateContactForceMeasurementInSensorFrame(KoContactWithSensor & contact, const sva::ForceVecd & measuredWrench);
+
+  /// @brief Updates the measurements of the force sensor attached to a contact whose frame is the one of a surface.
+  /// @details Expresses the measured wrench in the frame of the surface using the last computed kinematics of the
+  /// sensor in this frame. Used when the contacts are detected from surfaces or from the solver.
   /// @param contact Contact associated to the sensor
-  /// @param surfaceSensorKine transformation from the sensor to the contact.
   /// @param measuredWrench measured wrench
-  void updateContactForceMeasurement(KoContactWithSensor & contact, const sva::ForceVecd & measuredWrench);
+  void updateContactForceMeasurementInSurfaceFrame(KoContactWithSensor & contact, const sva::ForceVecd & measuredWrench);
+
+  /// @brief Selects the functions computing the kinematics of the contacts and expressing their measured wrench,
+  /// depending on the contacts detection method, so the choice is not made again at every iteration.
+  void selectContactsKinematicsStrategies();
+
+  /// @brief Returns the kinematics of the contact in the world, which are the ones of its force sensor.
+  /// @param contact Contact of which we want to compute the kinematics
+  /// @param robot robot the contacts belong to
+  /// @param worldSensorKine kinematics of the force sensor in the world
+  stateObservation::kine::Kinematics contactWorldKinematicsFromSensor(
+      KoContactWithSensor & contact,
+      const mc_rbdyn::Robot & robot,
+      const stateObservation::kine::Kinematics & worldSensorKine);
+
+  /// @brief Returns the kinematics of the contact in the world, which are the ones of its surface.
+  /// @param contact Contact of which we want to compute the kinematics
+  /// @param robot robot the contacts belong to
+  /// @param worldSensorKine kinematics of the force sensor in the world
+  stateObservation::kine::Kinematics contactWorldKinematicsFromSurface(
+      KoContactWithSensor & contact,
+      const mc_rbdyn::Robot & robot,
+      const stateObservation::kine::Kinematics & worldSensorKine);
+
+  /// @brief Sets the type of odometry and the associated computation of the rest pose of the contacts.
+  /// @param odometryType The type of odometry to use.
+  void setOdometryType(const measurements::OdometryType & odometryType);
+
+  /// @brief Replaces the altitude of the rest pose of the contact by the one of the terrain if its heightmap is given,
+  /// otherwise by the one of the contact in the control robot.
+  /// @details Used by the flat odometry.
+  /// @param ctl Controller
+  /// @param contact Contact for which we compute the rest pose.
+  /// @param worldContactKineRef rest pose of the contact in the world, which is modified by this function.
+  void setFlatOdometryContactRest(const mc_control::MCController & ctl,
+                                  KoContactWithSensor & contact,
+                                  stateObservation::kine::Kinematics & worldContactKineRef);
 
   /// @brief Computes the rest pose of the contact in the world using the visco-elastic model.
   /// @details Uses the measured wrench to obtain the rest pose of the contact from the one obtained by forward
@@ -227,6 +430,22 @@ protected:
                                    KoContactWithSensor & contact,
                                    stateObservation::kine::Kinematics & worldContactKineRef);
 
+  /// @brief Gives to the contact the visco-elastic model configured for its surface (or its force sensor if it is not
+  /// associated to a surface), or the default one if no specific model was configured.
+  /// @param contact The contact to which the model is given.
+  void setContactViscoElasticModel(KoContactWithSensor & contact);
+
+  /// @brief Prepares the next planned contact given by the datastore when its landing is close, so its activation at
+  /// the touchdown doesn't select its visco-elastic model nor register its log entries anymore.
+  /// @param ctl Controller
+  /// @param logger Logger
+  void prewarmPlannedContact(const mc_control::MCController & ctl, mc_rtc::Logger & logger);
+
+  /// @brief Releases the prewarmed contact whose touchdown didn't happen (the plan changed or was withdrawn), and
+  /// removes its log entries.
+  /// @param logger Logger
+  void releasePrewarmedContact(mc_rtc::Logger & logger);
+
   /// @brief Update the contact or create it if it still does not exist.
   /// @details Called by \ref updateContacts(const mc_control::MCController & ctl, std::set<std::string> contacts,
   /// mc_rtc::Logger & logger).
@@ -345,7 +564,12 @@ private:
 
   // indicates if the current iteration encountered no issue, encountered one, or is inside the invincibility frame
   // (recovery frame after an error)
-  EstimationState estimationState_;
+  EstimationState estimationState_ = noIssue;
+
+  // indicates if the forward kinematics and velocity of the real robot were already computed upstream for the current
+  // joints configuration. If yes, the update of the real robot only moves the kinematics of its bodies to the new
+  // floating base.
+  bool jointsKinematicsUpdatedUpstream_ = false;
 
   // instance of the Kinetics Observer
   stateObservation::KineticsObserver observer_;
@@ -355,6 +579,9 @@ private:
   std::string robot_ = "";
   /* custom list of robots to display */
   std::shared_ptr<mc_rbdyn::Robots> my_robots_;
+  // measurements of the force sensors of the control robot, without the gravity computed from the kinematics of the
+  // input robot. Updated once per iteration.
+  forceSensorsCache::ForceSensorsCache inputForceSensors_;
   // std::string imuSensor_ = "";
   mc_rbdyn::BodySensorVector IMUs_; ///< list of IMUs
 
@@ -381,20 +608,31 @@ private:
   // maximum amount of IMUs that we want to use with the Kinetics Observer.
   int maxIMUs_ = 2;
 
-  // linear stiffness of contacts
-  stateObservation::Matrix3 linStiffness_;
-  // linear damping of contacts
-  stateObservation::Matrix3 linDamping_;
-  // angular stiffness of contacts
-  stateObservation::Matrix3 angStiffness_;
-  // linear damping of contacts
-  stateObservation::Matrix3 angDamping_;
+  // visco-elastic model of the contacts for which no specific model is configured
+  ContactViscoElasticModel defaultViscoElasticModel_;
+  // visco-elastic models configured for specific contacts, indexed by the name of their surface (or force sensor)
+  std::map<std::string, ContactViscoElasticModel> contactsViscoElasticModels_;
 
   // indicates if the debug logs have to be added.
   bool withDebugLogs_ = true;
+  // indicates if the observer is instantiated without gui and logger (replay or tuning tools). The debug logs are then
+  // disabled.
+  bool headless_ = false;
   // indicates if we want to perform odometry, and if yes, flat or 6d odometry
   using OdometryType = measurements::OdometryType;
   OdometryType odometryType_;
+  // modification of the rest pose of the contacts specific to the type of odometry, nullptr if none.
+  void (MCKineticsObserver::*odometryContactRestSetter_)(const mc_control::MCController &,
+                                                         KoContactWithSensor &,
+                                                         stateObservation::kine::Kinematics &) = nullptr;
+  // computes the kinematics of a contact in the world, selected depending on the contacts detection method
+  stateObservation::kine::Kinematics (MCKineticsObserver::*contactWorldKinematicsGetter_)(
+      KoContactWithSensor &,
+      const mc_rbdyn::Robot &,
+      const stateObservation::kine::Kinematics &) = &MCKineticsObserver::contactWorldKinematicsFromSurface;
+  // expresses the measured wrench in the frame of a contact, selected depending on the contacts detection method
+  void (MCKineticsObserver::*contactForceMeasurementUpdater_)(KoContactWithSensor &, const sva::ForceVecd &) =
+      &MCKineticsObserver::updateContactForceMeasurementInSurfaceFrame;
   // indicates if we want to estimate the unmodeled wrench within the Kinetics Observer.
   bool withUnmodeledWrench_ = true;
   // indicates if we want to estimate the bias on the gyrometer measurement within the Kinetics Observer.
@@ -454,6 +692,16 @@ private:
   bool withFilteredForcesContactDetection_ = false;
   // threshold on the measured force for contact detection.
   double contactDetectionThreshold_ = 0.0;
+  // indicates if the planned contacts are prepared before their touchdown
+  bool withTouchdownPrewarming_ = false;
+  // datastore entry (std::string) giving the name of the next planned contact
+  std::string plannedContactEntry_ = "PlannedContact::Name";
+  // datastore entry (double) giving the remaining time (in s) before the expected landing of the planned contact
+  std::string timeToLandingEntry_ = "PlannedContact::TimeToLanding";
+  // the planned contact is prepared once its landing is expected within this duration (in s)
+  double prewarmingHorizon_ = 0.3;
+  // index of the prepared contact that didn't land yet, -1 if none
+  int prewarmedContact_ = -1;
   // list of the force sensors that cannot be used with contacts but we want to use their measurements as inputs to the
   // Kinetics Observer
   std::vector<std::string> forceSensorsAsInput_ = std::vector<std::string>();
@@ -492,6 +740,77 @@ private:
   // Buffer containing the estimated pose of the floating base in the world over the whole backup interval.
   boost::circular_buffer<stateObservation::kine::Kinematics> koBackupFbKinematics_;
 
+  /* Execution trace */
+  // maximum duration (in s) of run() before a dump of the execution trace is requested. Disabled if not positive.
+  double traceDeadline_ = 0.0;
+  // keeps the recording of the execution trace enabled while the observer exists, if requested in its configuration
+  traceTools::Session traceSession_;
+
+  /* Performance counters */
+  // hardware counters measured around run()
+  perfCounters::PerfCounters perfCounters_;
+
+  // comparison of the estimation to a golden trajectory
+  goldenTools::GoldenTrajectory golden_;
+
+  // terrain heightmap giving the altitude of the new contacts in the flat odometry
+  heightmap::Heightmap heightmap_;
+
+  /* Throttling during the static phases */
+  // detects the standstill of the robot, during which the Kinetics Observer runs at a reduced rate
+  standstillTools::StandstillDetector standstill_;
+  // propagation of the estimation between two updates of the Kinetics Observer
+  imuPropagation::ImuPropagator imuPropagator_;
+  // number of iterations since the last update of the Kinetics Observer
+  int itersSinceCorrection_ = 0;
+  // number of iterations covered by the sampling time and the process covariance of the Kinetics Observer
+  int predictionIters_ = 1;
+
+  /* Multi-rate mode */
+  // number of iterations between two updates of the Kinetics Observer, 1 if updated at every iteration
+  int multiRatePeriod_ = 1;
+  // indicates if the accelerometer is used in the propagation between two updates (multi-rate and asynchronous modes),
+  // otherwise the linear velocity is kept constant
+  bool propagationWithAccelerometer_ = true;
+
+  /* Asynchronous mode */
+  // indicates if the Kinetics Observer is updated by a worker thread, the control thread using its last estimation
+  // predicted forward with the IMU
+  bool async_ = false;
+  // update of the Kinetics Observer on the worker thread
+  asyncTools::AsyncTask asyncUpdate_;
+  // indicates if an update was started and its result not processed yet
+  bool asyncUpdatePending_ = false;
+  // indicates if a refresh of the memory report was requested while the worker was running
+  bool memoryRefreshPending_ = false;
+  // measurements of the IMU since the start of the last update, used for the forward prediction of its result. Its
+  // capacity is allocated at configure time from the maximum lag allowed to the worker.
+  boost::circular_buffer<imuPropagation::ImuSample> asyncImuSamples_;
+  // number of IMU samples merged with the next one because the worker lagged behind more than allowed
+  unsigned int asyncMergedImuSamples_ = 0;
+  // anomaly simulation requested from the gui, applied when the Kinetics Observer is not being updated
+  bool simulateNan_ = false;
+
+  /* Flight recorder */
+  // indicates if the flight recorder is used
+  bool withFlightRecorder_ = false;
+  // keeps the last seconds of inputs, state and covariance in memory and dumps them on anomalies
+  flightRecorder::FlightRecorder flightRecorder_;
+  // estimation state and number of set contacts at the current iteration
+  Eigen::VectorXd flightRecorderStatus_;
+  // inputs of the last update: for each IMU {acc, gyro}, for each contact {isSet, wrench, fbContactPosition,
+  // fbContactOrientation (vector4)}, then {com, comDot, comDotDot, angularMomentum, inertia, additionalWrench}. In the
+  // asynchronous mode, they are the ones of the iteration at which the update was started.
+  Eigen::VectorXd flightRecorderInputs_;
+  // time of the iteration at which the inputs were captured
+  double flightRecorderInputsTime_ = 0.0;
+  // diagonal of the state covariance at the current iteration
+  Eigen::VectorXd flightRecorderCovDiag_;
+
+  /* Memory accounting */
+  // approximate memory held by the robots copies, buffers and the Kinetics Observer's filter
+  memoryTools::MemoryReport memoryReport_;
+
   /* Debug variables */
   // For logs only. Prediction of the measurements from the newly corrected state
   stateObservation::Vector correctedMeasurements_;
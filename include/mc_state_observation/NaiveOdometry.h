@@ -5,7 +5,11 @@
 #include <mc_rbdyn/Contact.h>
 #include <mc_rbdyn/Robot.h>
 
+#include <mc_state_observation/observersTools/batchTools.h>
 #include <mc_state_observation/observersTools/leggedOdometryTools.h>
+#include <mc_state_observation/observersTools/goldenTools.h>
+#include <mc_state_observation/observersTools/memoryTools.h>
+#include <mc_state_observation/observersTools/perfCounters.h>
 #include <state-observation/dynamics-estimators/kinetics-observer.hpp>
 
 #include <mc_observers/Observer.h>
@@ -27,6 +31,14 @@ struct NaiveOdometry : public mc_observers::Observer
 
   void update(mc_control::MCController & ctl) override;
 
+  /// @brief Runs the observer on a recorded sequence, see batchTools.h. The observer must be headless.
+  /// @param ctl Controller whose robots receive the recorded measurements
+  /// @param inputs Recorded measurements, one column per iteration
+  /// @param outputs Estimated kinematics of the floating base, preallocated with the size of the sequence
+  void runBatch(mc_control::MCController & ctl,
+                const batchTools::InputView & inputs,
+                batchTools::OutputView outputs);
+
 protected:
   void update(mc_rbdyn::Robot & robot);
 
@@ -128,8 +140,19 @@ private:
   leggedOdometry::LeggedOdometryManager odometryManager_;
 
   bool accUpdatedUpstream_ = false;
+  // indicates if the observer is instantiated without gui and logger (replay or tuning tools)
+  bool headless_ = false;
 
   using LoContactsManager = leggedOdometry::LeggedOdometryManager::ContactsManager;
+
+  // hardware performance counters measured around run()
+  perfCounters::PerfCounters perfCounters_;
+
+  // comparison of the estimation to a golden trajectory
+  goldenTools::GoldenTrajectory golden_;
+
+  // approximate memory held by the robots copies and buffers
+  memoryTools::MemoryReport memoryReport_;
 };
 
 } // namespace mc_state_observation
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <mc_state_observation/filtering.h>
+#include <mc_state_observation/observersTools/memoryTools.h>
+#include <mc_state_observation/observersTools/threadTools.h>
 #include <mc_state_observation/ros.h>
 
 #include <mc_observers/Observer.h>
@@ -71,14 +73,19 @@ protected:
 
   /// @{
   bool isPublished_ = true; ///< Check if estimated robot is publish or not
+  double robotPublishRate_ = 50.0; ///< Publication rate of the estimated object (Hz)
+  double robotPublishElapsed_ = 0.0; ///< Time elapsed since the last publication of the estimated object
   /// @}
 
   mc_rtc::NodeHandlePtr nh_ = nullptr;
   void rosSpinner();
   std::thread thread_;
+  threadTools::ThreadConfiguration spinnerThread_{"objectSpinner"}; ///< Placement and scheduling of the ROS spinner
 
   bool isEstimatedPoseValid_ = false;
 
   bool isNotFirstTimeInCallback_ = false;
+
+  memoryTools::MemoryReport memoryReport_; ///< Approximate memory held by the robots copy
 };
 } // namespace mc_state_observation
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <mc_state_observation/filtering.h>
+#include <mc_state_observation/observersTools/memoryTools.h>
+#include <mc_state_observation/observersTools/noiseTools.h>
+#include <mc_state_observation/observersTools/threadTools.h>
 #include <mc_state_observation/ros.h>
+#include <mc_state_observation/tf_publisher.h>
 
 #include <mc_observers/Observer.h>
 
@@ -85,9 +89,12 @@ protected:
   mc_rtc::NodeHandlePtr nh_ = nullptr;
   void rosSpinner();
   std::thread thread_;
+  threadTools::ThreadConfiguration spinnerThread_{"slamSpinner"}; ///< Placement and scheduling of the ROS spinner
   tf2_ros::Buffer tfBuffer_;
   tf2_ros::TransformListener tfListener_{tfBuffer_};
   tf2_ros::TransformBroadcaster tfBroadcaster_;
+  TfPublisher tfPublisher_{tfBroadcaster_}; ///< Publishes the TF frames outside of the control thread
+  size_t mapFrame_ = 0; ///< Index of the robot_map -> map frame in tfPublisher_
 
   /// @{
   bool isFiltered_ = false; ///< Check if a filter is apply or not
@@ -98,6 +105,10 @@ protected:
 
   /// @{
   bool isPublished_ = true; ///< Check if estimated robot is publish or not
+  double robotPublishRate_ = 50.0; ///< Publication rate of the estimated robot (Hz)
+  double robotPublishElapsed_ = 0.0; ///< Time elapsed since the last publication of the estimated robot
+  double tfPublishRate_ = 100.0; ///< Publication rate of the robot_map -> map frame (Hz)
+  threadTools::ThreadConfiguration publisherThread_{"slamTfPublisher"}; ///< Placement and scheduling of the publisher
   /// @}
 
   /// @{
@@ -107,12 +118,19 @@ protected:
   Eigen::Vector3d maxOrientationNoise_ = Eigen::Vector3d(0.05, 0.05, 0.05);
   Eigen::Vector3d minTranslationNoise_ = Eigen::Vector3d(-0.01, -0.01, -0.01);
   Eigen::Vector3d maxTranslationNoise_ = Eigen::Vector3d(0.01, 0.01, 0.01);
+  noiseTools::NoiseEngine::Vector6 lowerPoseNoise_; ///< Lower bounds of the pose noise (orientation, translation)
+  noiseTools::NoiseEngine::Vector6 upperPoseNoise_; ///< Upper bounds of the pose noise (orientation, translation)
+  noiseTools::NoiseEngine noiseEngine_; ///< Generates the noise and dropouts of the simulated SLAM
+  noiseTools::DelayLine<sva::PTransformd> simulationDelay_; ///< Delay of the simulated SLAM
+  double simulationDropout_ = 0.0; ///< Probability of a dropout of the simulated SLAM at each iteration
   /// @}
 
   /// @{
   bool plotsEnabled_ = false; ///< Are GUI plots enabled
   /// @}
 
+  memoryTools::MemoryReport memoryReport_; ///< Approximate memory held by the robots copy and buffers
+
   double t_ = 0.0;
 };
 } // namespace mc_state_observation
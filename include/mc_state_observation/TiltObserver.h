@@ -2,7 +2,11 @@
 
 #include <mc_observers/Observer.h>
 #include <boost/circular_buffer.hpp>
+#include <mc_state_observation/observersTools/batchTools.h>
 #include <mc_state_observation/observersTools/leggedOdometryTools.h>
+#include <mc_state_observation/observersTools/goldenTools.h>
+#include <mc_state_observation/observersTools/memoryTools.h>
+#include <mc_state_observation/observersTools/perfCounters.h>
 #include <state-observation/observer/tilt-estimator-humanoid.hpp>
 #include <state-observation/tools/rigid-body-kinematics.hpp>
 
@@ -22,8 +26,10 @@ public:
   bool run(const mc_control::MCController & ctl) override;
 
   /// @brief updates the kinematics of the anchor frame of the robot in the world
+  /// @tparam withOdometry Indicates if the legged odometry is performed
   /// @param ctl Controller
   /// @param updatedRobot robot corresponding to the control robot with updated encoders
+  template<bool withOdometry>
   void updateAnchorFrame(const mc_control::MCController & ctl, const mc_rbdyn::Robot & updatedRobot);
 
   /// @brief updates the kinematics of the anchor frame of our odometry robot in the world
@@ -35,21 +41,34 @@ public:
   void updateAnchorFrameNoOdometry(const mc_control::MCController & ctl, const mc_rbdyn::Robot & updatedRobot);
 
   /// @brief updates the pose and the velcoity of the floating base in the world frame using our estimation results
+  /// @tparam withOdometry Indicates if the legged odometry is performed
   /// @param localWorldImuLinVel estimated local linear velocity of the IMU in the world frame
   /// @param localWorldImuAngVelestimated measurement of the gyrometer
+  template<bool withOdometry>
   void updatePoseAndVel(const stateObservation::Vector3 & localWorldImuLinVel,
                         const stateObservation::Vector3 & localWorldImuAngVel);
 
   /*! \brief update the robot pose in the world only for visualization purpose
    *
-   * @param updatedRobot Robot with the kinematics of the control robot but with updated joint values.
+   * The robot with the kinematics of the control robot but with updated joint values is the odometry robot if the
+   * legged odometry is performed.
+   * @tparam withOdometry Indicates if the legged odometry is performed
    */
-  void runTiltEstimator(const mc_control::MCController & ctl, const mc_rbdyn::Robot & updatedRobot);
+  template<bool withOdometry>
+  void runTiltEstimator(const mc_control::MCController & ctl);
 
   /// @brief Updates the real robot and/or the IMU signal using our estimation results
   /// @param ctl Controller
   void update(mc_control::MCController & ctl) override;
 
+  /// @brief Runs the observer on a recorded sequence, see batchTools.h. The observer must be headless.
+  /// @param ctl Controller whose robots receive the recorded measurements
+  /// @param inputs Recorded measurements, one column per iteration
+  /// @param outputs Estimated kinematics of the floating base, preallocated with the size of the sequence
+  void runBatch(mc_control::MCController & ctl,
+                const batchTools::InputView & inputs,
+                batchTools::OutputView outputs);
+
   /// @brief Backup function that returns the estimated displacement of the floating base in the world wrt to the
   /// initial one over the backup interval.
   /// @param ctl Controller
@@ -71,6 +90,16 @@ public:
   /// @param newOdometryType The new type of odometry to use.
   void changeOdometryType(const std::string & newOdometryType);
 
+  /** Floating-base transform estimate.
+   *
+   */
+  inline const sva::PTransformd & posW() const { return poseW_; }
+
+  /** Floating-base velocity estimate.
+   *
+   */
+  inline const sva::MotionVecd & velW() const { return velW_; }
+
 protected:
   /*! \brief update the robot pose in the world only for visualization purpose
    *
@@ -108,8 +137,13 @@ protected:
 
   std::string robot_; // name of the robot
   bool updateRobot_ = true; // indicates whether we use our estimation to update the real robot or not
+  // indicates whether the forward kinematics and velocity of the real robot were computed upstream for the current
+  // joints configuration. If yes, the update of the real robot only moves its bodies to the new floating base.
+  bool jointsKinematicsUpdatedUpstream_ = false;
   std::string imuSensor_; // IMU used for the estimation
   bool updateSensor_ = true; // indicates whether we update the IMU signal or not
+  // indicates if the observer is instantiated without gui and logger (replay or tuning tools)
+  bool headless_ = false;
 
   /*!
    * parameter related to the convergence of the linear velocity
@@ -201,6 +235,9 @@ protected:
   using OdometryType = measurements::OdometryType;
 
   leggedOdometry::LeggedOdometryManager odometryManager_; // manager for the legged odometry
+  // estimation with or without the legged odometry, selected at configure time as the odometry is either used or not
+  // for the whole lifetime of the observer
+  void (TiltObserver::*tiltEstimatorRunner_)(const mc_control::MCController &) = &TiltObserver::runTiltEstimator<false>;
   using LoContactsManager = leggedOdometry::LeggedOdometryManager::ContactsManager;
   double contactDetectionThreshold_; // threshold used for the contacts detection
 
@@ -217,6 +254,16 @@ protected:
   sva::MotionVecd imuVelC_;
   // pose of the IMU in the anchor frame
   sva::PTransformd X_C_IMU_;
+
+  /* Performance counters */
+  // hardware counters measured around run()
+  perfCounters::PerfCounters perfCounters_;
+
+  // comparison of the estimation to a golden trajectory
+  goldenTools::GoldenTrajectory golden_;
+
+  // approximate memory held by the robots copies and buffers
+  memoryTools::MemoryReport memoryReport_;
 };
 
 } // namespace mc_state_observation
@@ -0,0 +1,76 @@
+/**
+ * \file      asyncTools.h
+ * \brief      Execution of a task of an observer on a dedicated worker thread.
+ *
+ * \details
+ * Allows an observer to run its expensive estimation step without blocking the control thread: the control thread
+ * prepares the data of the task, launches it and checks at the next iterations if it is complete. The data used by the
+ * task must not be accessed by the control thread while running() is true. Completing the task publishes its writes to
+ * the control thread.
+ */
+
+#pragma once
+
+#include <mc_state_observation/observersTools/threadTools.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace mc_state_observation
+{
+namespace asyncTools
+{
+
+/// @brief Task run on a dedicated worker thread each time it is launched.
+class AsyncTask
+{
+public:
+  AsyncTask() = default;
+  /// @brief Waits for the running task and stops the worker thread.
+  ~AsyncTask();
+
+  AsyncTask(const AsyncTask &) = delete;
+  AsyncTask & operator=(const AsyncTask &) = delete;
+
+  /// @brief Starts the worker thread.
+  /// @param task Function executed by the worker thread at each launch.
+  /// @param config Placement and scheduling of the worker thread.
+  /// @param owner Name of the observer owning the task, used in the logs.
+  void start(std::function<void()> task, const threadTools::ThreadConfiguration & config, const std::string & owner);
+
+  /// @brief Indicates if the worker thread is started.
+  inline bool started() const noexcept { return thread_.joinable(); }
+
+  /// @brief Indicates if the task is running.
+  inline bool running() const noexcept { return running_.load(std::memory_order_acquire); }
+
+  /// @brief Launches the task on the worker thread. The task must not be running.
+  void launch();
+
+  /// @brief Blocks until the task is complete. Returns immediately if the task is not running.
+  void wait();
+
+private:
+  /// @brief Loop of the worker thread, waiting for a launch to run the task.
+  void workerLoop();
+
+private:
+  std::function<void()> task_;
+  std::string owner_;
+  std::thread thread_;
+  std::mutex mutex_;
+  // notifies the worker that the task is launched or that it must stop
+  std::condition_variable launchCv_;
+  // notifies the waiting thread that the task is complete
+  std::condition_variable doneCv_;
+  bool launched_ = false;
+  bool stop_ = false;
+  std::atomic<bool> running_{false};
+};
+
+} // namespace asyncTools
+} // namespace mc_state_observation
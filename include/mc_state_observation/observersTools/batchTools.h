@@ -0,0 +1,205 @@
+/**
+ * \file      batchTools.h
+ * \brief      Offline processing of recorded input sequences by the observers.
+ *
+ * \details
+ * Instead of stepping a controller tick by tick from a replayed log, the recorded measurements of a whole sequence are
+ * stored in contiguous arrays (one column per iteration) and the observer processes them in a single call to its
+ * runBatch() function, writing the estimated floating base kinematics in a preallocated output sequence.
+ *
+ * The sequences can also be given as views (InputView and OutputView) of arrays stored by another owner, such as the
+ * NumPy arrays of the Python bindings, which are then processed without copy.
+ *
+ * The batch loop resolves once the indices of the joints and sensors in the robots, writes the measurements of each
+ * iteration directly in the robots of the controller and calls the run() function of the observer without virtual
+ * dispatch. The observer must be headless (see headlessTools.h), so no logger callback is involved. The measurements
+ * are given with the same conventions as in the controller:
+ *  - encoders: one row per joint of the reference joint order of the robot (as the encoders of mc_rtc),
+ *  - encoderVelocities: same layout, may be left empty if not recorded,
+ *  - gyrometers and accelerometers: 3 rows per body sensor of the robot, in their order,
+ *  - wrenches: 6 rows (torque then force) per force sensor of the robot, in their order.
+ */
+
+#pragma once
+
+#include <mc_control/MCController.h>
+#include <mc_rtc/logging.h>
+#include <SpaceVecAlg/SpaceVecAlg>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace batchTools
+{
+
+/// @brief Recorded measurements of a sequence, one column per iteration.
+struct InputSequence
+{
+  Eigen::MatrixXd encoders;
+  Eigen::MatrixXd encoderVelocities;
+  Eigen::MatrixXd gyrometers;
+  Eigen::MatrixXd accelerometers;
+  Eigen::MatrixXd wrenches;
+
+  /// @brief Number of iterations of the sequence.
+  inline Eigen::Index size() const noexcept { return encoders.cols(); }
+};
+
+/// @brief Non-owning view of the recorded measurements of a sequence, one column per iteration. Allows to process
+/// measurements stored by another owner (for example NumPy arrays in Fortran order) without copying them.
+struct InputView
+{
+  /// @brief View of an input sequence.
+  InputView(const InputSequence & inputs)
+  : InputView(inputs.encoders, inputs.encoderVelocities, inputs.gyrometers, inputs.accelerometers, inputs.wrenches)
+  {
+  }
+
+  /// @brief View of measurements stored by another owner.
+  InputView(const Eigen::Ref<const Eigen::MatrixXd> & encoders,
+            const Eigen::Ref<const Eigen::MatrixXd> & encoderVelocities,
+            const Eigen::Ref<const Eigen::MatrixXd> & gyrometers,
+            const Eigen::Ref<const Eigen::MatrixXd> & accelerometers,
+            const Eigen::Ref<const Eigen::MatrixXd> & wrenches)
+  : encoders(encoders), encoderVelocities(encoderVelocities), gyrometers(gyrometers), accelerometers(accelerometers),
+    wrenches(wrenches)
+  {
+  }
+
+  Eigen::Ref<const Eigen::MatrixXd> encoders;
+  Eigen::Ref<const Eigen::MatrixXd> encoderVelocities;
+  Eigen::Ref<const Eigen::MatrixXd> gyrometers;
+  Eigen::Ref<const Eigen::MatrixXd> accelerometers;
+  Eigen::Ref<const Eigen::MatrixXd> wrenches;
+
+  /// @brief Number of iterations of the sequence.
+  inline Eigen::Index size() const noexcept { return encoders.cols(); }
+};
+
+/// @brief Estimated kinematics of the floating base in the world, one column per iteration.
+struct OutputSequence
+{
+  Eigen::MatrixXd positions;
+  // quaternions of the orientations, in the order of Eigen's coefficients (x, y, z, w)
+  Eigen::MatrixXd orientations;
+  Eigen::MatrixXd linVels;
+  Eigen::MatrixXd angVels;
+
+  /// @brief Allocates the outputs of a sequence with the given number of iterations.
+  inline void resize(Eigen::Index nbIters)
+  {
+    positions.resize(3, nbIters);
+    orientations.resize(4, nbIters);
+    linVels.resize(3, nbIters);
+    angVels.resize(3, nbIters);
+  }
+
+  /// @brief Number of iterations of the sequence.
+  inline Eigen::Index size() const noexcept { return positions.cols(); }
+};
+
+/// @brief Non-owning view of the preallocated outputs of a sequence, one column per iteration.
+struct OutputView
+{
+  /// @brief View of an output sequence.
+  OutputView(OutputSequence & outputs)
+  : OutputView(outputs.positions, outputs.orientations, outputs.linVels, outputs.angVels)
+  {
+  }
+
+  /// @brief View of outputs stored by another owner.
+  OutputView(Eigen::Ref<Eigen::MatrixXd> positions,
+             Eigen::Ref<Eigen::MatrixXd> orientations,
+             Eigen::Ref<Eigen::MatrixXd> linVels,
+             Eigen::Ref<Eigen::MatrixXd> angVels)
+  : positions(positions), orientations(orientations), linVels(linVels), angVels(angVels)
+  {
+  }
+
+  Eigen::Ref<Eigen::MatrixXd> positions;
+  // quaternions of the orientations, in the order of Eigen's coefficients (x, y, z, w)
+  Eigen::Ref<Eigen::MatrixXd> orientations;
+  Eigen::Ref<Eigen::MatrixXd> linVels;
+  Eigen::Ref<Eigen::MatrixXd> angVels;
+
+  /// @brief Number of iterations of the sequence.
+  inline Eigen::Index size() const noexcept { return positions.cols(); }
+
+  /// @brief Stores the estimated kinematics of the given iteration.
+  inline void set(Eigen::Index iter, const sva::PTransformd & X, const sva::MotionVecd & v)
+  {
+    positions.col(iter) = X.translation();
+    orientations.col(iter) = Eigen::Quaterniond(X.rotation().transpose()).coeffs();
+    linVels.col(iter) = v.linear();
+    angVels.col(iter) = v.angular();
+  }
+};
+
+/// @brief Writes the measurements of the iterations of a sequence in the robots of the controller.
+class InputsWriter
+{
+public:
+  /// @brief Constructor. Resolves the indices of the joints and checks the sizes of the measurements.
+  /// @param ctl The controller whose robots are updated.
+  /// @param robotName Name of the robot.
+  /// @param inputs The recorded sequence.
+  /// @param owner Name of the observer, used in the logs.
+  InputsWriter(mc_control::MCController & ctl,
+               const std::string & robotName,
+               const InputView & inputs,
+               const std::string & owner);
+
+  /// @brief Writes the measurements of the given iteration in the robot and in the real robot and updates the
+  /// kinematics of the real robot.
+  void write(Eigen::Index iter);
+
+private:
+  mc_rbdyn::Robot & robot_;
+  mc_rbdyn::Robot & realRobot_;
+  const InputView & inputs_;
+
+  // index in the configuration of the real robot of each joint of the reference joint order, -1 if not in the mbc
+  std::vector<int> mbcIndices_;
+  std::vector<double> encoders_;
+  std::vector<double> encoderVelocities_;
+};
+
+/// @brief Runs an observer on a recorded sequence.
+/// @param ctl The controller whose robots are updated.
+/// @param robotName Name of the robot.
+/// @param inputs The recorded sequence.
+/// @param outputs The estimated kinematics, must be preallocated with the size of the sequence.
+/// @param owner Name of the observer, used in the logs.
+/// @param step Runs an iteration of the observer and gives its estimation, called as step(X, v) with X the pose and v
+/// the velocity of the floating base in the world.
+template<typename Step>
+void runBatch(mc_control::MCController & ctl,
+              const std::string & robotName,
+              const InputView & inputs,
+              OutputView & outputs,
+              const std::string & owner,
+              Step && step)
+{
+  if(outputs.size() != inputs.size() || outputs.orientations.cols() != inputs.size()
+     || outputs.linVels.cols() != inputs.size() || outputs.angVels.cols() != inputs.size())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] The outputs must be preallocated for the {} iterations of the sequence", owner, inputs.size());
+  }
+
+  InputsWriter writer(ctl, robotName, inputs, owner);
+  sva::PTransformd X = sva::PTransformd::Identity();
+  sva::MotionVecd v = sva::MotionVecd::Zero();
+  for(Eigen::Index iter = 0; iter < inputs.size(); iter++)
+  {
+    writer.write(iter);
+    step(X, v);
+    outputs.set(iter, X, v);
+  }
+}
+
+} // namespace batchTools
+} // namespace mc_state_observation
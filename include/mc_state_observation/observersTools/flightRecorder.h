@@ -0,0 +1,130 @@
+/**
+ * \file      flightRecorder.h
+ * \brief      Bounded-memory recorder of the last seconds of an estimator's data, dumped to a binary file on request.
+ *
+ * \details
+ * The recorder stores fixed-size records made of named blocks of doubles (raw inputs, state, covariance diagonal,
+ * ...) into a ring buffer allocated once at initialization. Recording a tick only consists in memcpy calls, so it can
+ * be left always on in the real-time loop. When a dump is requested (anomaly detected, GUI button), recording is frozen
+ * and a background thread writes the content of the ring buffer to a binary file, then recording resumes.
+ *
+ * File layout (native endianness, doubles are IEEE-754 binary64):
+ *    char[8]   magic "MCSOFR01"
+ *    uint32    number of blocks
+ *    for each block: uint32 name length, char[] name, uint32 block size (in doubles)
+ *    uint64    number of records
+ *    for each record (oldest first): double time, then the blocks in the declared order
+ */
+
+#pragma once
+
+#include <mc_state_observation/observersTools/threadTools.h>
+
+#include <Eigen/Core>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace flightRecorder
+{
+
+/// @brief Description of a block of data contained in each record.
+struct Block
+{
+  std::string name;
+  uint32_t size;
+};
+
+/// @brief Ring buffer of fixed-size records with an asynchronous binary dump.
+class FlightRecorder
+{
+public:
+  FlightRecorder() = default;
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder & operator=(const FlightRecorder &) = delete;
+
+  /// @brief Allocates the ring buffer and starts the thread in charge of the dumps.
+  /// @param name Name of the recorder, used as a prefix of the dumped files.
+  /// @param directory Directory in which the files are dumped.
+  /// @param blocks Layout of a record.
+  /// @param capacity Number of records kept in memory.
+  /// @param threadConfig Placement and scheduling of the thread in charge of the dumps.
+  void init(const std::string & name,
+            const std::string & directory,
+            const std::vector<Block> & blocks,
+            size_t capacity,
+            const threadTools::ThreadConfiguration & threadConfig = threadTools::ThreadConfiguration("flightRecorder"));
+
+  /// @brief Copies a new record in the ring buffer, overwriting the oldest one if full. Does nothing while a dump is
+  /// ongoing.
+  /// @details The given vectors must match the declared blocks, both in order and size. No allocation is performed.
+  /// @param t Time of the record.
+  /// @param blocks Data of each block.
+  void record(double t, std::initializer_list<const Eigen::VectorXd *> blocks);
+
+  /// @brief Requests the dump of the ring buffer to a file. Can be called from the real-time thread.
+  /// @param reason Reason of the dump, appended to the file name. Must point to a string with static storage.
+  /// @return false if a dump is already ongoing or if the recorder is not initialized.
+  bool requestDump(const char * reason);
+
+  /// @brief Loads a file written by the recorder.
+  /// @param path Path of the file.
+  /// @param blocks Layout of the records, filled by this function.
+  /// @param times Time of each record, filled by this function.
+  /// @param records Records stored as columns (without the time), filled by this function.
+  static void load(const std::string & path,
+                   std::vector<Block> & blocks,
+                   std::vector<double> & times,
+                   Eigen::MatrixXd & records);
+
+  inline bool initialized() const noexcept { return initialized_; }
+  inline bool dumping() const noexcept { return frozen_.load(std::memory_order_acquire); }
+  /// @brief Number of records that were not stored because a dump was ongoing.
+  inline uint64_t droppedRecords() const noexcept { return dropped_; }
+  /// @brief Number of files written so far.
+  inline uint64_t dumpsCount() const noexcept { return dumps_.load(std::memory_order_relaxed); }
+  /// @brief Memory allocated for the ring buffer (in bytes).
+  inline size_t bufferSize() const noexcept { return buffer_.size() * sizeof(double); }
+
+private:
+  void dumpLoop();
+  void writeFile();
+
+private:
+  std::string name_;
+  std::string directory_;
+  std::vector<Block> blocks_;
+  bool initialized_ = false;
+
+  // number of doubles in a record, including the time
+  size_t recordSize_ = 0;
+  size_t capacity_ = 0;
+  // index of the slot in which the next record is written
+  size_t head_ = 0;
+  // number of valid records
+  size_t count_ = 0;
+  std::vector<double> buffer_;
+  uint64_t dropped_ = 0;
+
+  // true while the dump thread owns the buffer
+  std::atomic<bool> frozen_{false};
+  std::atomic<const char *> reason_{nullptr};
+  std::atomic<uint64_t> dumps_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+} // namespace flightRecorder
+} // namespace mc_state_observation
@@ -0,0 +1,108 @@
+/**
+ * \file      forceSensorsCache.h
+ * \brief      Force sensors measurements preprocessed once per iteration and shared between the observers.
+ *
+ * \details
+ * The contact detection of each observer and the inputs of the Kinetics Observer read the same force sensors and
+ * remove the gravity from their measurements several times per iteration. The cache computes, for all the force sensors
+ * of a robot, the raw wrench, the wrench without gravity in the sensor frame and in the floating base frame and the
+ * norm of the force without gravity. The indices of the sensors and of their parent bodies are resolved once.
+ *
+ * The removal of the gravity depends on the kinematics of the robot. The cache shared by the observers of a controller
+ * (shared()) uses the sensors and the kinematics of the control robot, as the contact detection of the observers. An
+ * observer using another robot for the kinematics (such as the input robot of the Kinetics Observer) owns its own
+ * cache.
+ *
+ * The shared cache doesn't rely on the time of the controller, which advances only when the logs are written. Each
+ * observer reading it registers as a reader and signals the start of each of its iterations (newIteration()). A new
+ * iteration of the controller starts when a reader starts a second iteration, the measurements are then computed again
+ * at the first read.
+ */
+
+#pragma once
+
+#include <mc_control/MCController.h>
+#include <mc_rbdyn/Robot.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace forceSensorsCache
+{
+
+/// @brief Preprocessed measurements of a force sensor.
+struct ForceSensorMeasurements
+{
+  // name of the sensor
+  std::string name_;
+  // wrench measured by the sensor, in the sensor frame
+  sva::ForceVecd wrench_ = sva::ForceVecd::Zero();
+  // measured wrench without the gravity, in the sensor frame
+  sva::ForceVecd wrenchWithoutGravity_ = sva::ForceVecd::Zero();
+  // measured wrench without the gravity, in the floating base frame
+  sva::ForceVecd fbWrenchWithoutGravity_ = sva::ForceVecd::Zero();
+  // norm of the measured force without the gravity
+  double forceNorm_ = 0.0;
+};
+
+/// @brief Measurements of all the force sensors of a robot, updated once per iteration.
+class ForceSensorsCache
+{
+public:
+  /// @brief Getter for the cache of the given robot shared by the observers of the controller. The cache is created at
+  /// the first call and lives as long as an observer holds it.
+  /// @param ctl The controller.
+  /// @param robotName Name of the robot.
+  static std::shared_ptr<ForceSensorsCache> shared(const mc_control::MCController & ctl, const std::string & robotName);
+
+  /// @brief Registers an observer reading the cache and returns its identifier.
+  size_t addReader();
+
+  /// @brief Signals the start of an iteration of the given reader. Must be called by each reader at every iteration of
+  /// the controller, including the ones where it doesn't read the measurements.
+  /// @param reader Identifier returned by addReader().
+  void newIteration(size_t reader);
+
+  /// @brief Getter for the measurements of the current iteration, computed at the first call of the iteration.
+  /// @param robot Robot giving the measurements and the kinematics.
+  const ForceSensorsCache & measurements(const mc_rbdyn::Robot & robot);
+
+  /// @brief Updates the measurements.
+  /// @param sensorsRobot Robot whose force sensors give the measurements.
+  /// @param kinematicsRobot Robot whose kinematics are used to remove the gravity and to express the wrenches in the
+  /// floating base frame.
+  void update(const mc_rbdyn::Robot & sensorsRobot, const mc_rbdyn::Robot & kinematicsRobot);
+
+  /// @brief Getter for the measurements of a sensor.
+  /// @param sensorName Name of the force sensor.
+  const ForceSensorMeasurements & operator()(const std::string & sensorName) const;
+
+  /// @brief Getter for the measurements of all the sensors.
+  inline const std::vector<ForceSensorMeasurements> & sensors() const noexcept { return sensors_; }
+
+private:
+  /// @brief Resolves the indices of the sensors and of their parent bodies.
+  void resolveIndices(const mc_rbdyn::Robot & sensorsRobot, const mc_rbdyn::Robot & kinematicsRobot);
+
+private:
+  std::vector<ForceSensorMeasurements> sensors_;
+  // index of the parent body of each sensor in the kinematics robot
+  std::vector<unsigned int> parentIndices_;
+  // index of each sensor in sensors_
+  std::unordered_map<std::string, size_t> indices_;
+  // name of the robots the indices were resolved for
+  std::string sensorsRobotName_;
+  std::string kinematicsRobotName_;
+
+  // readers that started the current iteration of the controller
+  std::vector<bool> iteratingReaders_;
+  // indicates if the measurements were computed during the current iteration of the controller
+  bool upToDate_ = false;
+};
+
+} // namespace forceSensorsCache
+} // namespace mc_state_observation
@@ -0,0 +1,147 @@
+/**
+ * \file      goldenTools.h
+ * \brief      Comparison of the estimation of an observer to a stored golden trajectory.
+ *
+ * \details
+ * Guards the refactors of the observers: a sequence (recorded log replayed with mc_rtc's replay plugin, or a synthetic
+ * controller) is run once in "record" mode to store the estimated pose and velocity and the duration of each iteration.
+ * After a change, the same sequence is run in "compare" mode: each iteration is compared to the stored one with a
+ * tolerance per signal, and a summary giving the maximum errors and the mean duration of the iterations (current and
+ * golden) is logged at the end of the sequence, so that accuracy and speed are tracked together.
+ *
+ * Configuration:
+ *    mode: compare        # record or compare
+ *    file: /tmp/golden.txt
+ *    tolerances:
+ *      position: 1e-6     # [m]
+ *      orientation: 1e-6  # [rad]
+ *      linVel: 1e-6       # [m/s]
+ *      angVel: 1e-6       # [rad/s]
+ *    relative: false      # if true, the tolerances of the position and velocities are relative to the norm of the
+ *                         # golden value (absolute below 1)
+ *
+ * The iterations are matched by their index, the sequence must start from the same state in both modes.
+ *
+ * The same comparison is run by the goldenSequences test (tests/), which drives the observers on short synthetic
+ * sequences whose golden trajectories are stored in the repository.
+ */
+
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/log/Logger.h>
+#include <SpaceVecAlg/SpaceVecAlg>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace goldenTools
+{
+
+/// @brief Records or compares the estimation of an observer to a golden trajectory.
+class GoldenTrajectory
+{
+public:
+  /// @brief Compared signals.
+  enum Signal
+  {
+    position = 0,
+    orientation,
+    linVel,
+    angVel,
+    nbSignals
+  };
+
+  GoldenTrajectory() = default;
+  /// @brief Writes the recorded trajectory or logs the summary of the comparison.
+  ~GoldenTrajectory();
+
+  GoldenTrajectory(const GoldenTrajectory &) = delete;
+  GoldenTrajectory & operator=(const GoldenTrajectory &) = delete;
+
+  /// @brief Reads the configuration. In compare mode, the golden trajectory is loaded.
+  /// @param config Configuration of the golden trajectory.
+  /// @param owner Name of the observer, used in the logs.
+  void configure(const mc_rtc::Configuration & config, const std::string & owner);
+
+  /// @brief Indicates if the estimation is recorded or compared.
+  inline bool enabled() const noexcept { return mode_ != Mode::disabled; }
+
+  /// @brief Beginning of an iteration of the observer.
+  inline void start()
+  {
+    if(enabled()) { start_ = std::chrono::steady_clock::now(); }
+  }
+
+  /// @brief End of an iteration of the observer.
+  /// @param X Estimated pose of the floating base in the world.
+  /// @param v Estimated velocity of the floating base in the world.
+  inline void stop(const sva::PTransformd & X, const sva::MotionVecd & v)
+  {
+    if(enabled()) { add(X, v, std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count()); }
+  }
+
+  /// @brief Records or compares an iteration whose duration was measured by the caller, for example an iteration of a
+  /// batch processing (see batchTools.h).
+  /// @param X Estimated pose of the floating base in the world.
+  /// @param v Estimated velocity of the floating base in the world.
+  /// @param duration Duration of the iteration (in s).
+  void add(const sva::PTransformd & X, const sva::MotionVecd & v, double duration);
+
+  /// @brief Writes the recorded trajectory or logs the summary of the comparison. Called at destruction if not called
+  /// before.
+  /// @return False if the recorded trajectory could not be written or if the estimation differs from the golden one.
+  bool finish();
+
+  /// @brief Adds the errors of the current iteration and the duration of the iterations to the logs.
+  void addToLogger(mc_rtc::Logger & logger, const std::string & category);
+
+  /// @brief Removes the entries added by addToLogger.
+  void removeFromLogger(mc_rtc::Logger & logger, const std::string & category);
+
+private:
+  enum class Mode
+  {
+    disabled,
+    record,
+    compare
+  };
+
+  // pose (translation then quaternion w, x, y, z), velocity (linear then angular) and duration of an iteration
+  using Sample = std::array<double, 14>;
+
+private:
+  Mode mode_ = Mode::disabled;
+  std::string owner_;
+  std::string file_;
+  bool finished_ = false;
+  // result of finish()
+  bool success_ = true;
+
+  std::array<double, nbSignals> tolerances_ = {1e-6, 1e-6, 1e-6, 1e-6};
+  // indicates if the tolerances of the position and velocities are relative to the golden values
+  bool relativeTolerances_ = false;
+  std::array<double, nbSignals> errors_ = {0.0, 0.0, 0.0, 0.0};
+  std::array<double, nbSignals> maxErrors_ = {0.0, 0.0, 0.0, 0.0};
+  // number of iterations exceeding the tolerance of each signal
+  std::array<size_t, nbSignals> violations_ = {0, 0, 0, 0};
+
+  // recorded trajectory (record mode) or golden trajectory (compare mode)
+  std::vector<Sample> samples_;
+  // index of the current iteration
+  size_t iter_ = 0;
+
+  std::chrono::steady_clock::time_point start_;
+  // duration of the last iteration (in s)
+  double duration_ = 0.0;
+  double totalDuration_ = 0.0;
+  // sum of the durations of the golden iterations that were compared
+  double totalGoldenDuration_ = 0.0;
+};
+
+} // namespace goldenTools
+} // namespace mc_state_observation
@@ -0,0 +1,68 @@
+/**
+ * \file      headlessTools.h
+ * \brief      Instantiation of the observers outside of a running controller, without gui and logger.
+ *
+ * \details
+ * Replay and tuning tools create many instances of an observer (one per set of parameters for example). In the
+ * controller, the observers add robot displays, buttons and checkboxes to the gui and register log entries from their
+ * configure and reset functions, which is expensive for many instances and makes their names collide. The observers
+ * configured with "headless: true" skip all these registrations (addToLogger and addToGUI are only called by the
+ * observers pipeline, which is not used here).
+ *
+ * All the headless observers of a tool can share a single controller built from the robot module, which only provides
+ * the robots, the datastore and the time step:
+ *    auto ctl = headlessTools::makeController(robotModule, 0.005);
+ *    auto observer = headlessTools::makeObserver<MCKineticsObserver>(*ctl, "MCKineticsObserver", config);
+ *
+ * The tool then updates the robots of the controller from its data and calls run() on each observer.
+ *
+ * The observers exchanging data through the datastore (the Kinetics Observer and the Tilt Observer used as its backup)
+ * publish fixed entries, so each pair needs its own controller.
+ */
+
+#pragma once
+
+#include <mc_control/MCController.h>
+#include <mc_rbdyn/RobotModule.h>
+#include <mc_rtc/Configuration.h>
+
+#include <memory>
+#include <string>
+
+namespace mc_state_observation
+{
+namespace headlessTools
+{
+
+/// @brief Creates a controller providing the robots, the datastore and the time step to headless observers.
+/// @param robotModule Module of the robot.
+/// @param dt Time step of the observers.
+inline std::unique_ptr<mc_control::MCController> makeController(
+    const std::shared_ptr<mc_rbdyn::RobotModule> & robotModule,
+    double dt)
+{
+  return std::make_unique<mc_control::MCController>(robotModule, dt);
+}
+
+/// @brief Creates, configures and resets a headless observer.
+/// @tparam ObserverT Type of the observer.
+/// @param ctl Controller providing the robots, the datastore and the time step.
+/// @param type Type of the observer, given to its constructor.
+/// @param config Configuration of the observer, the "headless" entry is added.
+template<typename ObserverT>
+std::unique_ptr<ObserverT> makeObserver(const mc_control::MCController & ctl,
+                                        const std::string & type,
+                                        const mc_rtc::Configuration & config)
+{
+  mc_rtc::Configuration observerConfig;
+  observerConfig.load(config);
+  observerConfig.add("headless", true);
+
+  auto observer = std::make_unique<ObserverT>(type, ctl.timeStep);
+  observer->configure(ctl, observerConfig);
+  observer->reset(ctl);
+  return observer;
+}
+
+} // namespace headlessTools
+} // namespace mc_state_observation
@@ -0,0 +1,122 @@
+/**
+ * \file      heightmap.h
+ * \brief      Terrain heightmap giving the altitude of the new contacts of the flat odometry.
+ *
+ * \details
+ * The flat odometry assumes that the altitude of a new contact is known (0 for the legged odometry, the altitude of the
+ * contact of the control robot for the Kinetics Observer). On stairs or slopes this assumption is wrong. If the terrain
+ * is known, its altitude is given by a regular grid with a bilinear interpolation between the nodes, so that the flat
+ * odometry can be used on uneven terrain.
+ *
+ * The heights are given at the nodes (origin + resolution * (i, j)), i along x and j along y. The queries outside the
+ * grid return the altitude of the closest border. The coefficients of the bilinear interpolation of the last queried
+ * cell are kept, as the successive queries are often made on the same cell (a foot landing several times on the same
+ * step).
+ *
+ * Configuration:
+ *    file: /path/to/heightmap.bin  # binary file, see load()
+ *    datastore: Terrain::Heightmap # or entry of the datastore containing a Heightmap, resolved at the reset
+ *
+ * Binary file (little endian): the magic "MCSOHMAP", the number of nodes along x and y (uint32), the origin x and y and
+ * the resolution (double, in m), then the heights (double, in m) of the nodes with x varying first.
+ */
+
+#pragma once
+
+#include <mc_control/MCController.h>
+#include <mc_rtc/Configuration.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <string>
+
+namespace mc_state_observation
+{
+namespace heightmap
+{
+
+/// @brief Regular grid of the terrain altitude with bilinear interpolation.
+class Heightmap
+{
+public:
+  Heightmap() = default;
+
+  /// @brief Constructor from the heights of the nodes.
+  /// @param origin Position of the node (0, 0) in the world.
+  /// @param resolution Distance between two consecutive nodes.
+  /// @param heights Heights of the nodes, the rows are along x and the columns along y.
+  Heightmap(const Eigen::Vector2d & origin, double resolution, const Eigen::MatrixXd & heights);
+
+  /// @brief Reads the configuration. The heightmap given by a file is loaded immediately, the one given by the
+  /// datastore is retrieved by resolve().
+  /// @param config Configuration of the heightmap.
+  /// @param owner Name of the observer, used in the logs.
+  void configure(const mc_rtc::Configuration & config, const std::string & owner);
+
+  /// @brief Retrieves the heightmap from the datastore if configured this way. Must be called once the controller had
+  /// the possibility to fill the datastore (on the reset of the observer).
+  /// @param ctl The controller.
+  void resolve(const mc_control::MCController & ctl);
+
+  /// @brief Loads the heightmap from a binary file.
+  /// @param file Path of the file.
+  void load(const std::string & file);
+
+  /// @brief Indicates if a heightmap was loaded.
+  inline bool loaded() const noexcept { return heights_.size() > 0; }
+
+  /// @brief Memory allocated for the heights of the nodes (in bytes).
+  inline size_t bufferSize() const noexcept { return static_cast<size_t>(heights_.size()) * sizeof(double); }
+
+  /// @brief Returns the altitude of the terrain at the given horizontal position.
+  /// @param x Position along the x axis of the world.
+  /// @param y Position along the y axis of the world.
+  inline double height(double x, double y) const
+  {
+    const double u = (x - origin_.x()) / resolution_;
+    const double v = (y - origin_.y()) / resolution_;
+    const Eigen::Index i = cellIndex(u, heights_.rows());
+    const Eigen::Index j = cellIndex(v, heights_.cols());
+    if(i != cachedI_ || j != cachedJ_) { cacheCell(i, j); }
+
+    // local coordinates in the cell, clamped to the grid
+    const double du = std::min(std::max(u - static_cast<double>(i), 0.0), 1.0);
+    const double dv = std::min(std::max(v - static_cast<double>(j), 0.0), 1.0);
+    return coeffs_(0) + coeffs_(1) * du + coeffs_(2) * dv + coeffs_(3) * du * dv;
+  }
+
+private:
+  /// @brief Returns the index of the cell containing the given grid coordinate, clamped to the grid.
+  inline static Eigen::Index cellIndex(double coordinate, Eigen::Index nbNodes)
+  {
+    if(nbNodes < 2 || !(coordinate > 0.0)) { return 0; }
+    return std::min(static_cast<Eigen::Index>(coordinate), nbNodes - 2);
+  }
+
+  /// @brief Computes the coefficients of the bilinear interpolation on the given cell.
+  void cacheCell(Eigen::Index i, Eigen::Index j) const;
+
+  /// @brief Checks the validity of the grid.
+  void check(const std::string & source) const;
+
+private:
+  std::string owner_ = "Heightmap";
+  // entry of the datastore containing the heightmap, empty if not given by the datastore
+  std::string datastoreKey_;
+
+  // position of the node (0, 0) in the world
+  Eigen::Vector2d origin_ = Eigen::Vector2d::Zero();
+  // distance between two consecutive nodes
+  double resolution_ = 1.0;
+  // heights of the nodes, the rows are along x and the columns along y
+  Eigen::MatrixXd heights_;
+
+  // cell of the last query and coefficients of its bilinear interpolation h = c0 + c1 * du + c2 * dv + c3 * du * dv
+  mutable Eigen::Index cachedI_ = -1;
+  mutable Eigen::Index cachedJ_ = -1;
+  mutable Eigen::Vector4d coeffs_ = Eigen::Vector4d::Zero();
+};
+
+} // namespace heightmap
+} // namespace mc_state_observation
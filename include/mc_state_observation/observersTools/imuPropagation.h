@@ -0,0 +1,76 @@
+/**
+ * \file      imuPropagation.h
+ * \brief      Lightweight propagation of the floating base kinematics between two full estimations.
+ *
+ * \details
+ * When the full estimation of an observer doesn't run at every iteration, its outputs are propagated at the controller
+ * rate from the kinematics given by the last full estimation:
+ *  - the angular velocity of the floating base is the one measured by the gyrometer (corrected with the bias estimated
+ * by the last full estimation) minus the one of the IMU relative to the floating base, given by the encoders,
+ *  - if the accelerometer is used, the linear acceleration of the floating base is the one of the IMU (measured
+ * acceleration minus gravity) minus the part due to the motion of the IMU relative to the floating base, otherwise
+ * the linear velocity is kept constant.
+ *
+ * The measurements of an iteration can be stored as an ImuSample, to propagate later an estimation that was delayed
+ * (asynchronous update of the observer).
+ */
+
+#pragma once
+
+#include <state-observation/tools/rigid-body-kinematics.hpp>
+
+namespace mc_state_observation
+{
+namespace imuPropagation
+{
+
+/// @brief Measurements of the IMU and its kinematics in the floating base's frame at an iteration.
+struct ImuSample
+{
+  // kinematics of the IMU in the floating base's frame (pose, velocities and accelerations)
+  stateObservation::kine::Kinematics fbImuKine;
+  stateObservation::Vector3 gyro = stateObservation::Vector3::Zero();
+  stateObservation::Vector3 acc = stateObservation::Vector3::Zero();
+  // duration of the iteration
+  double dt = 0.0;
+};
+
+/// @brief Propagates the kinematics of the floating base in the world with the IMU measurements.
+class ImuPropagator
+{
+public:
+  /// @brief Restarts the propagation from the kinematics given by a full estimation.
+  /// @param worldFbKine Kinematics of the floating base in the world (pose and velocities).
+  /// @param gyroBias Bias of the gyrometer, subtracted from the measurements.
+  void reset(const stateObservation::kine::Kinematics & worldFbKine, const stateObservation::Vector3 & gyroBias);
+
+  /// @brief Propagates the kinematics over a time step.
+  /// @param fbImuKine Kinematics of the IMU in the floating base's frame (pose, velocities and accelerations).
+  /// @param gyro Measurement of the gyrometer.
+  /// @param acc Measurement of the accelerometer.
+  /// @param dt Duration of the time step.
+  /// @param withAccelerometer If false, the linear velocity is kept constant.
+  void propagate(const stateObservation::kine::Kinematics & fbImuKine,
+                 const stateObservation::Vector3 & gyro,
+                 const stateObservation::Vector3 & acc,
+                 double dt,
+                 bool withAccelerometer);
+
+  /// @brief Propagates the kinematics over the iteration of the given sample.
+  /// @param sample Measurements of the iteration.
+  /// @param withAccelerometer If false, the linear velocity is kept constant.
+  inline void propagate(const ImuSample & sample, bool withAccelerometer)
+  {
+    propagate(sample.fbImuKine, sample.gyro, sample.acc, sample.dt, withAccelerometer);
+  }
+
+  /// @brief Propagated kinematics of the floating base in the world.
+  inline const stateObservation::kine::Kinematics & worldFbKine() const noexcept { return worldFbKine_; }
+
+private:
+  stateObservation::kine::Kinematics worldFbKine_;
+  stateObservation::Vector3 gyroBias_ = stateObservation::Vector3::Zero();
+};
+
+} // namespace imuPropagation
+} // namespace mc_state_observation
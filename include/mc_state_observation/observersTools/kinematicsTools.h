@@ -3,6 +3,7 @@
 #pragma once
 
 #include <mc_observers/api.h>
+#include <mc_rbdyn/Robot.h>
 #include <mc_rtc/gui/StateBuilder.h>
 #include <mc_rtc/log/Logger.h>
 #include <SpaceVecAlg/SpaceVecAlg>
@@ -108,6 +109,386 @@ stateObservation::kine::Kinematics & addVelsAndAccs(stateObservation::kine::Kine
 
 sva::PTransformd pTransformFromKinematics(const stateObservation::kine::Kinematics & kine);
 
+///////////////////////////////////////////////////////////////////////
+/// -----------------Kinematics with compile-time fields----------------
+///////////////////////////////////////////////////////////////////////
+
+/// @brief Fields of a StaticKinematics object.
+namespace staticFields
+{
+constexpr unsigned pose = 1 << 0;
+constexpr unsigned vel = 1 << 1;
+constexpr unsigned acc = 1 << 2;
+constexpr unsigned poseAndVel = pose | vel;
+constexpr unsigned all = pose | vel | acc;
+} // namespace staticFields
+
+/// @brief Kinematics of a frame A within a frame B whose fields (pose, velocities, accelerations) are known at compile
+/// time.
+/// @details Equivalent of the Kinematics object for the internal computations of the observers, in which the available
+/// fields are always the same. The compositions and inversions don't check any flag and the orientation is stored as a
+/// rotation matrix only. The conversions to and from Kinematics must be done at the boundaries with the
+/// state-observation API. The velocities and accelerations are expressed in the frame B, as in Kinematics.
+/// @tparam Fields Combination of the staticFields. The pose is mandatory and the accelerations require the velocities.
+template<unsigned Fields>
+class StaticKinematics
+{
+  static_assert(Fields & staticFields::pose, "The pose is mandatory");
+  static_assert(!(Fields & staticFields::acc) || (Fields & staticFields::vel),
+                "The accelerations require the velocities");
+
+public:
+  static constexpr bool withVel = (Fields & staticFields::vel) != 0;
+  static constexpr bool withAcc = (Fields & staticFields::acc) != 0;
+
+  /// @brief Creates the kinematics from a pose, with zero velocities and accelerations.
+  /// @param pTransform The pose of the frame A within B, stored as a sva PTransform object.
+  static StaticKinematics fromSva(const sva::PTransformd & pTransform)
+  {
+    StaticKinematics kine;
+    kine.position = pTransform.translation();
+    kine.orientation = pTransform.rotation().transpose();
+    return kine;
+  }
+
+  /// @brief Creates the kinematics from a pose and velocities, with zero accelerations.
+  /// @param pTransform The pose of the frame A within B, stored as a sva PTransform object.
+  /// @param vel The velocity of the frame A inside B.
+  /// @param velIsGlobal If true, the velocity vectors are expressed in the global frame (B), if false, they are
+  /// expressed in the local frame (A).
+  static StaticKinematics fromSva(const sva::PTransformd & pTransform,
+                                  const sva::MotionVecd & vel,
+                                  bool velIsGlobal = true)
+  {
+    static_assert(withVel, "The kinematics don't contain the velocities");
+    StaticKinematics kine = fromSva(pTransform);
+    kine.setVelocities(vel, velIsGlobal);
+    return kine;
+  }
+
+  /// @brief Creates the kinematics from a pose, velocities and accelerations.
+  /// @param pTransform The pose of the frame A within B, stored as a sva PTransform object.
+  /// @param vel The velocity of the frame A inside B.
+  /// @param acc The acceleration of the frame A inside B.
+  /// @param velIsGlobal If true, the velocity vectors are expressed in the global frame (B), if false, they are
+  /// expressed in the local frame (A).
+  /// @param accIsGlobal If true, the acceleration vectors are expressed in the global frame (B), if false, they are
+  /// expressed in the local frame (A).
+  static StaticKinematics fromSva(const sva::PTransformd & pTransform,
+                                  const sva::MotionVecd & vel,
+                                  const sva::MotionVecd & acc,
+                                  bool velIsGlobal = true,
+                                  bool accIsGlobal = true)
+  {
+    static_assert(withAcc, "The kinematics don't contain the accelerations");
+    StaticKinematics kine = fromSva(pTransform, vel, velIsGlobal);
+    kine.linAcc = accIsGlobal ? acc.linear() : Eigen::Vector3d(kine.orientation * acc.linear());
+    kine.angAcc = accIsGlobal ? acc.angular() : Eigen::Vector3d(kine.orientation * acc.angular());
+    return kine;
+  }
+
+  /// @brief Creates the kinematics from a Kinematics object, which must contain all the fields.
+  static StaticKinematics fromKinematics(const stateObservation::kine::Kinematics & kine)
+  {
+    BOOST_ASSERT(kine.position.isSet() && kine.orientation.isSet() && "The pose of the kinematics is not set");
+    StaticKinematics staticKine;
+    staticKine.position = kine.position();
+    staticKine.orientation = kine.orientation.toMatrix3();
+    if constexpr(withVel)
+    {
+      BOOST_ASSERT(kine.linVel.isSet() && kine.angVel.isSet() && "The velocities of the kinematics are not set");
+      staticKine.linVel = kine.linVel();
+      staticKine.angVel = kine.angVel();
+    }
+    if constexpr(withAcc)
+    {
+      BOOST_ASSERT(kine.linAcc.isSet() && kine.angAcc.isSet() && "The accelerations of the kinematics are not set");
+      staticKine.linAcc = kine.linAcc();
+      staticKine.angAcc = kine.angAcc();
+    }
+    return staticKine;
+  }
+
+  /// @brief Converts the kinematics to a Kinematics object, in which only the fields of this object are set.
+  stateObservation::kine::Kinematics toKinematics() const
+  {
+    stateObservation::kine::Kinematics kine;
+    kine.position = position;
+    kine.orientation = stateObservation::Matrix3(orientation);
+    if constexpr(withVel)
+    {
+      kine.linVel = linVel;
+      kine.angVel = angVel;
+    }
+    if constexpr(withAcc)
+    {
+      kine.linAcc = linAcc;
+      kine.angAcc = angAcc;
+    }
+    return kine;
+  }
+
+  /// @brief Sets the velocities of the frame.
+  /// @param vel The velocity of the frame A inside B.
+  /// @param velIsGlobal If true, the velocity vectors are expressed in the global frame (B), if false, they are
+  /// expressed in the local frame (A).
+  void setVelocities(const sva::MotionVecd & vel, bool velIsGlobal = true)
+  {
+    static_assert(withVel, "The kinematics don't contain the velocities");
+    linVel = velIsGlobal ? vel.linear() : Eigen::Vector3d(orientation * vel.linear());
+    angVel = velIsGlobal ? vel.angular() : Eigen::Vector3d(orientation * vel.angular());
+  }
+
+  /// @brief Composition with the kinematics of a frame C within A, giving the kinematics of C within B. The result
+  /// contains the fields common to both kinematics.
+  template<unsigned OtherFields>
+  StaticKinematics<Fields & OtherFields> operator*(const StaticKinematics<OtherFields> & multiplier) const
+  {
+    using Result = StaticKinematics<Fields & OtherFields>;
+    Result result;
+    const Eigen::Vector3d rotatedPos = orientation * multiplier.position;
+    result.position = position + rotatedPos;
+    result.orientation = orientation * multiplier.orientation;
+    if constexpr(Result::withVel)
+    {
+      const Eigen::Vector3d rotatedLinVel = orientation * multiplier.linVel;
+      const Eigen::Vector3d rotatedAngVel = orientation * multiplier.angVel;
+      result.linVel = linVel + angVel.cross(rotatedPos) + rotatedLinVel;
+      result.angVel = angVel + rotatedAngVel;
+      if constexpr(Result::withAcc)
+      {
+        result.linAcc = linAcc + orientation * multiplier.linAcc + angAcc.cross(rotatedPos)
+                        + angVel.cross(angVel.cross(rotatedPos)) + 2 * angVel.cross(rotatedLinVel);
+        result.angAcc = angAcc + orientation * multiplier.angAcc + angVel.cross(rotatedAngVel);
+      }
+    }
+    return result;
+  }
+
+  /// @brief Kinematics of the frame B within A.
+  StaticKinematics inverse() const
+  {
+    StaticKinematics inverted;
+    inverted.orientation = orientation.transpose();
+    inverted.position = -inverted.orientation * position;
+    if constexpr(withVel)
+    {
+      const Eigen::Vector3d angVelCrossPos = angVel.cross(position);
+      inverted.linVel = inverted.orientation * (angVelCrossPos - linVel);
+      inverted.angVel = -inverted.orientation * angVel;
+      if constexpr(withAcc)
+      {
+        inverted.linAcc = inverted.orientation
+                          * (angAcc.cross(position) - angVel.cross(angVelCrossPos) + 2 * angVel.cross(linVel) - linAcc);
+        inverted.angAcc = -inverted.orientation * angAcc;
+      }
+    }
+    return inverted;
+  }
+
+public:
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();
+  // orientation of the frame A in B (transpose of the rotation of sva)
+  Eigen::Matrix3d orientation = Eigen::Matrix3d::Identity();
+  // velocities and accelerations, only used if contained in the Fields
+  Eigen::Vector3d linVel = Eigen::Vector3d::Zero();
+  Eigen::Vector3d angVel = Eigen::Vector3d::Zero();
+  Eigen::Vector3d linAcc = Eigen::Vector3d::Zero();
+  Eigen::Vector3d angAcc = Eigen::Vector3d::Zero();
+};
+
+using PoseKinematics = StaticKinematics<staticFields::pose>;
+using PoseVelKinematics = StaticKinematics<staticFields::poseAndVel>;
+using FullKinematics = StaticKinematics<staticFields::all>;
+
+///////////////////////////////////////////////////////////////////////
+/// ---------------------Lazy kinematics compositions-------------------
+///////////////////////////////////////////////////////////////////////
+
+/// @brief Base of the deferred kinematics expressions.
+/// @details A chain of compositions and inversions built with lazy(...) is not evaluated until evaluate<Fields>() is
+/// called. The whole chain is then evaluated in one pass and only the requested fields are computed and read from the
+/// operands, for example evaluate<staticFields::pose>() never touches the velocities of the operands. The expressions
+/// store references to their operands, which must outlive the evaluation.
+template<typename Derived>
+class LazyKinematics
+{
+public:
+  inline const Derived & derived() const noexcept { return static_cast<const Derived &>(*this); }
+
+  /// @brief Evaluates the expression, computing only the given fields.
+  template<unsigned Fields>
+  StaticKinematics<Fields> evaluate() const
+  {
+    static_assert((Fields & ~Derived::availableFields) == 0, "The operands don't contain the requested fields");
+    return derived().template evaluateFields<Fields>();
+  }
+
+  /// @brief Deferred inversion of the expression.
+  inline auto inverse() const;
+};
+
+/// @brief Deferred composition of two expressions.
+template<typename Lhs, typename Rhs>
+class ComposedKinematics : public LazyKinematics<ComposedKinematics<Lhs, Rhs>>
+{
+public:
+  static constexpr unsigned availableFields = Lhs::availableFields & Rhs::availableFields;
+
+  ComposedKinematics(const Lhs & lhs, const Rhs & rhs) : lhs_(lhs), rhs_(rhs) {}
+
+  template<unsigned Fields>
+  StaticKinematics<Fields> evaluateFields() const
+  {
+    return lhs_.template evaluateFields<Fields>() * rhs_.template evaluateFields<Fields>();
+  }
+
+private:
+  Lhs lhs_;
+  Rhs rhs_;
+};
+
+/// @brief Deferred inversion of an expression.
+template<typename Expr>
+class InvertedKinematics : public LazyKinematics<InvertedKinematics<Expr>>
+{
+public:
+  static constexpr unsigned availableFields = Expr::availableFields;
+
+  explicit InvertedKinematics(const Expr & expr) : expr_(expr) {}
+
+  template<unsigned Fields>
+  StaticKinematics<Fields> evaluateFields() const
+  {
+    return expr_.template evaluateFields<Fields>().inverse();
+  }
+
+private:
+  Expr expr_;
+};
+
+/// @brief Leaf of an expression referring to a StaticKinematics object.
+template<unsigned OperandFields>
+class StaticKinematicsLeaf : public LazyKinematics<StaticKinematicsLeaf<OperandFields>>
+{
+public:
+  static constexpr unsigned availableFields = OperandFields;
+
+  explicit StaticKinematicsLeaf(const StaticKinematics<OperandFields> & kine) : kine_(kine) {}
+
+  template<unsigned Fields>
+  StaticKinematics<Fields> evaluateFields() const
+  {
+    StaticKinematics<Fields> kine;
+    kine.position = kine_.position;
+    kine.orientation = kine_.orientation;
+    if constexpr(StaticKinematics<Fields>::withVel)
+    {
+      kine.linVel = kine_.linVel;
+      kine.angVel = kine_.angVel;
+    }
+    if constexpr(StaticKinematics<Fields>::withAcc)
+    {
+      kine.linAcc = kine_.linAcc;
+      kine.angAcc = kine_.angAcc;
+    }
+    return kine;
+  }
+
+private:
+  const StaticKinematics<OperandFields> & kine_;
+};
+
+/// @brief Leaf of an expression referring to a Kinematics object. Only the requested fields are read, they must be
+/// set.
+class KinematicsLeaf : public LazyKinematics<KinematicsLeaf>
+{
+public:
+  static constexpr unsigned availableFields = staticFields::all;
+
+  explicit KinematicsLeaf(const stateObservation::kine::Kinematics & kine) : kine_(kine) {}
+
+  template<unsigned Fields>
+  StaticKinematics<Fields> evaluateFields() const
+  {
+    return StaticKinematics<Fields>::fromKinematics(kine_);
+  }
+
+private:
+  const stateObservation::kine::Kinematics & kine_;
+};
+
+/// @brief Leaf of an expression referring to a sva pose, with zero velocities and accelerations.
+class PoseLeaf : public LazyKinematics<PoseLeaf>
+{
+public:
+  static constexpr unsigned availableFields = staticFields::all;
+
+  explicit PoseLeaf(const sva::PTransformd & pose) : pose_(pose) {}
+
+  template<unsigned Fields>
+  StaticKinematics<Fields> evaluateFields() const
+  {
+    return StaticKinematics<Fields>::fromSva(pose_);
+  }
+
+private:
+  const sva::PTransformd & pose_;
+};
+
+template<typename Derived>
+inline auto LazyKinematics<Derived>::inverse() const
+{
+  return InvertedKinematics<Derived>(derived());
+}
+
+/// @brief Deferred composition of two expressions.
+template<typename Lhs, typename Rhs>
+inline ComposedKinematics<Lhs, Rhs> operator*(const LazyKinematics<Lhs> & lhs, const LazyKinematics<Rhs> & rhs)
+{
+  return ComposedKinematics<Lhs, Rhs>(lhs.derived(), rhs.derived());
+}
+
+/// @brief Starts a deferred expression from a StaticKinematics object.
+template<unsigned Fields>
+inline StaticKinematicsLeaf<Fields> lazy(const StaticKinematics<Fields> & kine)
+{
+  return StaticKinematicsLeaf<Fields>(kine);
+}
+template<unsigned Fields>
+void lazy(const StaticKinematics<Fields> &&) = delete;
+
+/// @brief Starts a deferred expression from a Kinematics object.
+inline KinematicsLeaf lazy(const stateObservation::kine::Kinematics & kine)
+{
+  return KinematicsLeaf(kine);
+}
+void lazy(const stateObservation::kine::Kinematics &&) = delete;
+
+/// @brief Starts a deferred expression from a sva pose, with zero velocities and accelerations.
+inline PoseLeaf lazy(const sva::PTransformd & pose)
+{
+  return PoseLeaf(pose);
+}
+void lazy(const sva::PTransformd &&) = delete;
+
+///////////////////////////////////////////////////////////////////////
+/// ---------------------Update of the robot kinematics-----------------
+///////////////////////////////////////////////////////////////////////
+
+/// @brief Sets the pose and velocity of the floating base of the robot and moves the kinematics of all its bodies in
+/// the world accordingly.
+/// @details The kinematics of the bodies in the frame of the floating base don't depend on the floating base, so the
+/// new kinematics of the bodies in the world are obtained by applying to the current ones the rigid transformation
+/// between the previous and the new floating base, and by transporting the change of velocity of the floating base.
+/// This avoids the complete forward kinematics and velocity, but requires that they were already computed for the
+/// current joints configuration and velocities (whatever the floating base). If the root joint of the robot is not a
+/// free joint, the complete forward kinematics and velocity are computed.
+/// @param robot The robot to update.
+/// @param X_0_fb The new pose of the floating base in the world.
+/// @param v_fb_0 The new velocity of the floating base in the world.
+void updateFloatingBase(mc_rbdyn::Robot & robot, const sva::PTransformd & X_0_fb, const sva::MotionVecd & v_fb_0);
+
 ///////////////////////////////////////////////////////////////////////
 /// -------------------------Logging functions-------------------------
 ///////////////////////////////////////////////////////////////////////
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <mc_state_observation/observersTools/heightmap.h>
 #include <mc_state_observation/observersTools/measurementsTools.h>
 #include <state-observation/dynamics-estimators/kinetics-observer.hpp>
 
@@ -150,6 +151,8 @@ public:
   /// @param verbose
   /// @param withModeSwitchInGui If true, adds the possiblity to switch between 6d and flat odometry from the gui.
   /// Should be set to false if this feature is implemented in the estimator using this library.
+  /// @param headless If true, nothing is added to the gui and to the logger, so the odometry can be instantiated in
+  /// bulk by replay or tuning tools.
   void init(const mc_control::MCController & ctl,
             const std::string & robotName,
             const std::string & odometryName,
@@ -158,7 +161,8 @@ public:
             const bool velUpdatedUpstream,
             const bool accUpdatedUpstream,
             const bool verbose,
-            const bool withModeSwitchInGui = false);
+            const bool withModeSwitchInGui = false,
+            const bool headless = false);
 
   /// @brief Initialization for a detection based on contact surfaces
   /// @param ctl Controller
@@ -378,9 +382,53 @@ public:
   /// @brief Getter for the odometry robot used for the estimation.
   mc_rbdyn::Robot & odometryRobot() { return odometryRobot_->robot("odometryRobot"); }
 
+  /// @brief Getter for the robots containing the odometry robot, null before the initialization.
+  const std::shared_ptr<mc_rbdyn::Robots> & odometryRobots() const { return odometryRobot_; }
+
   /// @brief Getter for the contacts manager.
   LeggedOdometryContactsManager & contactsManager() { return contactsManager_; }
 
+  /// @brief Getter for the terrain heightmap giving the altitude of the new contacts in the flat odometry. If not
+  /// loaded, the terrain is assumed flat at the altitude 0.
+  heightmap::Heightmap & heightmap() { return heightmap_; }
+
+protected:
+  /// @brief Selects the functions computing the kinematics of the contacts depending on the contacts detection method,
+  /// so the choice is not made again at every iteration.
+  void selectContactsKinematicsStrategies();
+
+  /// @brief Computes the reference kinematics of the newly set contact in the world, considering that the frame of the
+  /// force sensor is the one of the contact.
+  /// @details Used when the contacts are detected by thresholding the measured force.
+  /// @param contact The new contact
+  /// @param fs The force sensor associated to the contact
+  void setNewContactFromSensor(LoContactWithSensor & contact, const mc_rbdyn::ForceSensor & fs);
+
+  /// @brief Computes the reference kinematics of the newly set contact in the world, which are the ones of its
+  /// surface.
+  /// @details Used when the contacts are detected from surfaces or from the solver.
+  /// @param contact The new contact
+  /// @param fs The force sensor associated to the contact
+  void setNewContactFromSurface(LoContactWithSensor & contact, const mc_rbdyn::ForceSensor & fs);
+
+  /// @brief Computes the current kinematics of the contact in the world, considering that the frame of the force sensor
+  /// is the one of the contact.
+  /// @param contact Contact of which we want to compute the kinematics
+  /// @param fs The force sensor associated to the contact
+  /// @param worldSensorKine Kinematics of the force sensor in the world
+  void currentContactKinematicsFromSensor(LoContactWithSensor & contact,
+                                          const mc_rbdyn::ForceSensor & fs,
+                                          const stateObservation::kine::Kinematics & worldSensorKine);
+
+  /// @brief Computes the current kinematics of the contact in the world, which are the ones of its surface. Also
+  /// expresses the measured force in the frame of the surface.
+  /// @param contact Contact of which we want to compute the kinematics
+  /// @param fs The force sensor associated to the contact
+  /// @param worldSensorKine Kinematics of the force sensor in the world
+  void currentContactKinematicsFromSurface(LoContactWithSensor & contact,
+                                           const mc_rbdyn::ForceSensor & fs,
+                                           const stateObservation::kine::Kinematics & worldSensorKine);
+
 public:
   // Indicates if the mode of computation of the anchor frame changed. Might me needed by the estimator (ex;
   // TiltObserver)
@@ -403,10 +451,20 @@ protected:
 protected:
   // contacts manager used by this odometry manager
   LeggedOdometryContactsManager contactsManager_;
+  // computes the reference kinematics of a new contact, selected depending on the contacts detection method
+  void (LeggedOdometryManager::*newContactKinematicsSetter_)(LoContactWithSensor &, const mc_rbdyn::ForceSensor &) =
+      &LeggedOdometryManager::setNewContactFromSurface;
+  // computes the current kinematics of a contact, selected depending on the contacts detection method
+  void (LeggedOdometryManager::*currentContactKinematicsGetter_)(LoContactWithSensor &,
+                                                                 const mc_rbdyn::ForceSensor &,
+                                                                 const stateObservation::kine::Kinematics &) =
+      &LeggedOdometryManager::currentContactKinematicsFromSurface;
   // odometry robot that is updated by the legged odometry and can then update the real robot if required.
   std::shared_ptr<mc_rbdyn::Robots> odometryRobot_;
   // pose of the anchor frame of the robot in the world
   stateObservation::kine::Kinematics worldAnchorPose_;
+  // terrain heightmap giving the altitude of the new contacts in the flat odometry
+  heightmap::Heightmap heightmap_;
 
   // Indicates whether the velocity is updated by an upstream estimator. If yes, it is expressed in the newly obtained
   // floating base frame. Otherwise, it is computed by finite differences.
@@ -414,6 +472,8 @@ protected:
   // Indicates whether the acceleration is updated by an upstream estimator. If yes, it is expressed in the newly
   // obtained floating base frame. Otherwise, it is not updated.
   bool accUpdatedUpstream_ = false;
+  // Indicates whether the odometry was instantiated without gui and logger.
+  bool headless_ = false;
 };
 
 } // namespace leggedOdometry
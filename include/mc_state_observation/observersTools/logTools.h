@@ -0,0 +1,145 @@
+/**
+ * \file      logTools.h
+ * \brief      Rate-limited logging for the code executed on every iteration of the observers.
+ *
+ * \details
+ * Messages emitted from the real-time loop at every iteration flood the console and perform I/O on the real-time
+ * thread. MCSO_LOG_RATE_LIMITED(level, period, ...) emits the message at most once per period (in seconds) for a given
+ * call site. The message is only formatted when the period allows it. A message identical to the last one emitted by
+ * the call site is moreover deduplicated: it is only emitted again after RateLimiter::duplicatePeriods periods. The
+ * repetitions in between are only counted, and the count is appended to the next emitted message. The total number of
+ * suppressed messages is available through logTools::suppressedMessages(). As it is shared by all the observers, it is
+ * logged once under suppressedLogsEntry, whose entry is kept while at least one observer is logged.
+ *
+ * The state of a call site is shared by all the instances of the observers and all the threads (control loop, worker
+ * threads, batch processing), so it is only made of atomics.
+ */
+
+#pragma once
+
+#include <mc_rtc/log/Logger.h>
+#include <mc_rtc/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+namespace mc_state_observation
+{
+namespace logTools
+{
+
+/// @brief Name of the log entry of the total number of suppressed messages.
+constexpr const char * suppressedLogsEntry = "mc_state_observation_suppressedLogs";
+
+/// @brief Total number of messages suppressed by the rate limiters of all the call sites.
+uint64_t suppressedMessages() noexcept;
+
+/// @brief Adds a suppressed message to the total count.
+void addSuppressedMessage() noexcept;
+
+/// @brief Adds the log entry of the total number of suppressed messages on behalf of an observer. The entry is added
+/// for the first observer logged by the logger.
+/// @param logger Logger of the observer.
+void addToLogger(mc_rtc::Logger & logger);
+
+/// @brief Removes the log entry of the total number of suppressed messages on behalf of an observer. The entry is
+/// removed with the last observer logged by the logger.
+/// @param logger Logger of the observer.
+void removeFromLogger(mc_rtc::Logger & logger);
+
+/// @brief State of a rate-limited call site. A single instance is created for each call site by
+/// MCSO_LOG_RATE_LIMITED, shared by all the threads.
+class RateLimiter
+{
+public:
+  /// @brief Number of periods during which a message identical to the last emitted one is suppressed.
+  static constexpr int duplicatePeriods = 10;
+
+  explicit RateLimiter(double period)
+  : period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(period))
+                .count())
+  {
+  }
+
+  /// @brief Checks if the period elapsed since the last message allowed by the call site. If not, the message is
+  /// counted as suppressed. Only one of the threads calling the function at the same time is allowed.
+  inline bool allow() noexcept
+  {
+    const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    int64_t lastAllowed = lastAllowed_.load(std::memory_order_acquire);
+    if((lastAllowed != never && now - lastAllowed < period_)
+       || !lastAllowed_.compare_exchange_strong(lastAllowed, now, std::memory_order_acq_rel))
+    {
+      suppress();
+      return false;
+    }
+    return true;
+  }
+
+  /// @brief Checks if a message allowed by allow() is not a duplicate of the last emitted one. If it is, it is counted
+  /// as suppressed.
+  /// @param message Formatted message.
+  /// @param suppressed Number of messages suppressed since the last emitted one, set only if the function returns
+  /// true.
+  inline bool emit(const std::string & message, uint64_t & suppressed) noexcept
+  {
+    const int64_t now = lastAllowed_.load(std::memory_order_acquire);
+    const size_t hash = std::hash<std::string>{}(message);
+    const int64_t lastEmission = lastEmission_.load(std::memory_order_acquire);
+    if(lastEmission != never && hash == lastHash_.load(std::memory_order_acquire)
+       && now - lastEmission < duplicatePeriods * period_)
+    {
+      suppress();
+      return false;
+    }
+    lastHash_.store(hash, std::memory_order_release);
+    lastEmission_.store(now, std::memory_order_release);
+    suppressed = suppressed_.exchange(0, std::memory_order_acq_rel);
+    return true;
+  }
+
+private:
+  inline void suppress() noexcept
+  {
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    addSuppressedMessage();
+  }
+
+private:
+  static constexpr int64_t never = std::numeric_limits<int64_t>::min();
+
+  // period in ticks of the steady clock
+  const int64_t period_;
+  // time of the last message allowed by the period, in ticks of the steady clock
+  std::atomic<int64_t> lastAllowed_{never};
+  // time of the last emitted message and hash of its content
+  std::atomic<int64_t> lastEmission_{never};
+  std::atomic<size_t> lastHash_{0};
+  // number of messages suppressed since the last emitted one
+  std::atomic<uint64_t> suppressed_{0};
+};
+
+} // namespace logTools
+} // namespace mc_state_observation
+
+/// @brief Emits mc_rtc::log::LEVEL(...) at most once every PERIOD seconds for this call site, and deduplicates the
+/// identical messages.
+#define MCSO_LOG_RATE_LIMITED(LEVEL, PERIOD, ...)                                                            \
+  do                                                                                                         \
+  {                                                                                                          \
+    static ::mc_state_observation::logTools::RateLimiter mcsoRateLimiter_(PERIOD);                           \
+    if(mcsoRateLimiter_.allow())                                                                             \
+    {                                                                                                        \
+      const std::string mcsoMessage_ = fmt::format(__VA_ARGS__);                                             \
+      uint64_t mcsoSuppressed_ = 0;                                                                          \
+      if(mcsoRateLimiter_.emit(mcsoMessage_, mcsoSuppressed_))                                               \
+      {                                                                                                      \
+        if(mcsoSuppressed_ == 0) { ::mc_rtc::log::LEVEL("{}", mcsoMessage_); }                               \
+        else { ::mc_rtc::log::LEVEL("{} ({} similar messages suppressed)", mcsoMessage_, mcsoSuppressed_); } \
+      }                                                                                                      \
+    }                                                                                                        \
+  } while(0)
@@ -16,6 +16,8 @@
 #include <mc_rbdyn/Robot.h>
 #include <mc_rtc/log/Logger.h>
 #include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/forceSensorsCache.h>
+#include <mc_state_observation/observersTools/logTools.h>
 
 namespace mc_state_observation
 {
@@ -553,8 +555,9 @@ public:
   }
   ~ContactsManager() {}
 
-  // initialization of the odometry
-  void init(const std::string & observerName, const bool verbose = true);
+  // initialization of the odometry. The checkboxes enabling the sensors of the contacts are added to the gui only if
+  // withGui is true.
+  void init(const std::string & observerName, const bool verbose = true, const bool withGui = true);
 
   /// @brief Initialization for a detection based on contact surfaces
   /// @param ctl Controller
@@ -604,8 +607,14 @@ public:
   std::string set_to_string(const ContactsSet & contactSet);
 
   /// @brief Updates the list of currently set contacts and returns it.
+  /// @details Starts a new iteration of the manager on the force sensors measurements shared with the other observers.
   /// @return std::set<FoundContactsListType> &
   const ContactsSet & findContacts(const mc_control::MCController & ctl, const std::string & robotName);
+  /// @brief Starts a new iteration of the manager on the force sensors measurements shared with the other observers.
+  /// @details Called by \ref findContacts(const mc_control::MCController & ctl). Must be called instead by the
+  /// observers skipping the detection of the contacts on some iterations, so the shared measurements are refreshed at
+  /// each iteration of the controller.
+  void newIteration(const mc_control::MCController & ctl, const std::string & robotName);
   /// @brief Updates the list @contactsFound_ of currently set contacts directly from the controller.
   /// @details Called by \ref findContacts(const mc_control::MCController & ctl) if @contactsDetection_ is equal to
   /// "fromSolver". The contacts are given by the controller directly (then thresholded based on the measured force).
@@ -719,6 +728,15 @@ protected:
   // method used to detect the contacts
   ContactsDetection contactsDetectionMethod_ = undefined;
   bool verbose_ = true;
+  // indicates if the contacts are added to the gui
+  bool withGui_ = true;
+
+  // force sensors measurements shared with the other observers
+  std::shared_ptr<forceSensorsCache::ForceSensorsCache> forceSensorsCache_;
+  // identifier of the manager among the readers of the shared measurements
+  size_t forceSensorsCacheReader_ = 0;
+  // robot of the shared measurements
+  std::string forceSensorsCacheRobot_;
 };
 
 // allowed odometry types
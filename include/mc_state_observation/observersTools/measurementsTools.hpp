@@ -12,10 +12,12 @@ namespace measurements
 
 template<typename ContactWithSensorT, typename ContactWithoutSensorT>
 void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::init(const std::string & observerName,
-                                                                      const bool verbose)
+                                                                      const bool verbose,
+                                                                      const bool withGui)
 {
   observerName_ = observerName;
   verbose_ = verbose;
+  withGui_ = withGui;
 }
 
 template<typename ContactWithSensorT, typename ContactWithoutSensorT>
@@ -153,6 +155,7 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::addContactToGui
                                                                                  const std::string & surface,
                                                                                  bool)
 {
+  if(!withGui_) { return; }
   ctl.gui()->addElement(
       {observerName_, "Contacts"},
       mc_rtc::gui::Checkbox(
@@ -173,6 +176,7 @@ template<typename ContactWithSensorT, typename ContactWithoutSensorT>
 void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::addContactToGui(const mc_control::MCController & ctl,
                                                                                  const std::string & fsName)
 {
+  if(!withGui_) { return; }
   ctl.gui()->addElement(
       {observerName_, "Contacts"},
       mc_rtc::gui::Checkbox(
@@ -190,6 +194,7 @@ const std::set<int> & ContactsManager<ContactWithSensorT, ContactWithoutSensorT>
     const mc_control::MCController & ctl,
     const std::string & robotName)
 {
+  newIteration(ctl, robotName);
   // Detection of the contacts depending on the configured mode
   (this->*contactsFinder_)(ctl, robotName);
   updateContacts();
@@ -197,16 +202,31 @@ const std::set<int> & ContactsManager<ContactWithSensorT, ContactWithoutSensorT>
   return contactsFound_; // list of currently set contacts
 }
 
+template<typename ContactWithSensorT, typename ContactWithoutSensorT>
+void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::newIteration(const mc_control::MCController & ctl,
+                                                                                const std::string & robotName)
+{
+  if(!forceSensorsCache_ || forceSensorsCacheRobot_ != robotName)
+  {
+    forceSensorsCache_ = forceSensorsCache::ForceSensorsCache::shared(ctl, robotName);
+    forceSensorsCacheReader_ = forceSensorsCache_->addReader();
+    forceSensorsCacheRobot_ = robotName;
+  }
+  forceSensorsCache_->newIteration(forceSensorsCacheReader_);
+}
+
 template<typename ContactWithSensorT, typename ContactWithoutSensorT>
 void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFromSolver(
     const mc_control::MCController & ctl,
     const std::string & robotName)
 {
-  mc_rtc::log::warning("This mode has not been tested deeply, there might be issues with the contacts surfaces and "
-                       "names. There seems to be an issue when the robot turns in LipmWalking using legged odometry. "
-                       "This issue doesn't occur with the other detection methods so there must be a problem with the "
-                       "contacts list or the contacts kinematics not turning? To check");
+  MCSO_LOG_RATE_LIMITED(warning, 10.0,
+                        "This mode has not been tested deeply, there might be issues with the contacts surfaces and "
+                        "names. There seems to be an issue when the robot turns in LipmWalking using legged odometry. "
+                        "This issue doesn't occur with the other detection methods so there must be a problem with the "
+                        "contacts list or the contacts kinematics not turning? To check");
   const auto & measRobot = ctl.robot(robotName);
+  const auto & forceSensors = forceSensorsCache_->measurements(measRobot);
 
   contactsFound_.clear();
   for(const auto & contact : ctl.solver().contacts())
@@ -221,7 +241,7 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
           const auto & fs = measRobot.surfaceForceSensor(surfaceName);
           mapContacts_.insertContact(fs.name(), surfaceName, true);
           ContactWithSensor & contactWS = mapContacts_.contactWithSensor(surfaceName);
-          contactWS.forceNorm_ = fs.wrenchWithoutGravity(measRobot).force().norm();
+          contactWS.forceNorm_ = forceSensors(fs.name()).forceNorm_;
           if(contactWS.forceNorm_ > contactDetectionThreshold_)
           {
             // the contact is added to the map of contacts using the name of the associated sensor
@@ -233,7 +253,7 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
           const auto & ifs = measRobot.indirectSurfaceForceSensor(surfaceName);
           mapContacts_.insertContact(ifs.name(), surfaceName, false);
           ContactWithSensor & contactWS = mapContacts_.contactWithSensor(surfaceName);
-          contactWS.forceNorm_ = ifs.wrenchWithoutGravity(measRobot).force().norm();
+          contactWS.forceNorm_ = forceSensors(ifs.name()).forceNorm_;
           if(contactWS.forceNorm_ > contactDetectionThreshold_)
           {
             // the contact is added to the map of contacts using the name of the associated sensor
@@ -253,7 +273,7 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
           const auto & fs = measRobot.surfaceForceSensor(surfaceName);
           mapContacts_.insertContact(fs.name(), surfaceName, true);
           ContactWithSensor & contactWS = mapContacts_.contactWithSensor(surfaceName);
-          contactWS.forceNorm_ = fs.wrenchWithoutGravity(measRobot).force().norm();
+          contactWS.forceNorm_ = forceSensors(fs.name()).forceNorm_;
           if(contactWS.forceNorm_ > contactDetectionThreshold_)
           {
 
@@ -266,7 +286,7 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
           const auto & ifs = measRobot.indirectSurfaceForceSensor(surfaceName);
           mapContacts_.insertContact(ifs.name(), surfaceName, false);
           ContactWithSensor & contactWS = mapContacts_.contactWithSensor(surfaceName);
-          contactWS.forceNorm_ = ifs.wrenchWithoutGravity(measRobot).force().norm();
+          contactWS.forceNorm_ = forceSensors(ifs.name()).forceNorm_;
           if(contactWS.forceNorm_ > contactDetectionThreshold_)
           {
             // the contact is added to the map of contacts using the name of the associated sensor
@@ -284,16 +304,13 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
     const mc_control::MCController & ctl,
     const std::string & robotName)
 {
-  const auto & measRobot = ctl.robot(robotName);
+  const auto & forceSensors = forceSensorsCache_->measurements(ctl.robot(robotName));
 
   contactsFound_.clear();
 
   for(auto & contact : mapContacts_.contactsWithSensors())
   {
-    const std::string & fsName = contact.second.forceSensorName();
-    const mc_rbdyn::ForceSensor forceSensor = measRobot.forceSensor(fsName);
-
-    contact.second.forceNorm_ = forceSensor.wrenchWithoutGravity(measRobot).force().norm();
+    contact.second.forceNorm_ = forceSensors(contact.second.forceSensorName()).forceNorm_;
     if(contact.second.forceNorm_ > contactDetectionThreshold_)
     {
       //  the contact is added to the map of contacts using the name of the associated surface
@@ -307,15 +324,13 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
     const mc_control::MCController & ctl,
     const std::string & robotName)
 {
-  const auto & measRobot = ctl.robot(robotName);
+  const auto & forceSensors = forceSensorsCache_->measurements(ctl.robot(robotName));
 
   contactsFound_.clear();
 
   for(auto & contact : mapContacts_.contactsWithSensors())
   {
-    const std::string & fsName = contact.second.forceSensorName();
-    const mc_rbdyn::ForceSensor forceSensor = measRobot.forceSensor(fsName);
-    contact.second.forceNorm_ = forceSensor.wrenchWithoutGravity(measRobot).force().norm();
+    contact.second.forceNorm_ = forceSensors(contact.second.forceSensorName()).forceNorm_;
     if(contact.second.forceNorm_ > contactDetectionThreshold_)
     {
       // the contact is added to the map of contacts using the name of the associated sensor
@@ -329,7 +344,9 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::updateContacts(
 {
   /** Debugging output **/
   if(verbose_ && contactsFound_ != oldContacts_)
+  {
     mc_rtc::log::info("[{}] Contacts changed: {}", observerName_, set_to_string(contactsFound_));
+  }
 
   for(const auto & foundContact : contactsFound_)
   {
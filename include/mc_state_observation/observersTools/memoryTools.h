@@ -0,0 +1,129 @@
+/**
+ * \file      memoryTools.h
+ * \brief      Approximate accounting of the memory held by the observers.
+ *
+ * \details
+ * Each observer declares the major components it holds (copies of the robots, backup ring buffers, filter windows,
+ * state and covariance of the estimator, ...) in a MemoryReport, with a function estimating the number of bytes of each
+ * component. The estimations are refreshed on demand (reset of the observer, GUI button), never in the real-time loop,
+ * and exposed in the logs and the GUI, which allows to size the buffers and to find the robot copies worth dropping.
+ *
+ * The estimations are approximate: they count the memory allocated by the containers (capacity, not size) and the
+ * size of the objects themselves, but not the allocator overhead. For the robots, the multibody, its configuration and
+ * the sensors are counted, the surfaces, convexes and collision meshes are not. The closures stored by the logger and
+ * the GUI are not counted either, as mc_rtc doesn't expose them.
+ */
+
+#pragma once
+
+#include <mc_rbdyn/Robots.h>
+#include <mc_rtc/gui/StateBuilder.h>
+#include <mc_rtc/log/Logger.h>
+
+#include <boost/circular_buffer.hpp>
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace memoryTools
+{
+
+/// @brief Memory allocated by a vector.
+template<typename T, typename Allocator>
+inline size_t bytes(const std::vector<T, Allocator> & vector)
+{
+  return vector.capacity() * sizeof(T);
+}
+
+/// @brief Memory allocated by a vector of vectors, including the inner vectors.
+template<typename T, typename InnerAllocator, typename Allocator>
+inline size_t bytes(const std::vector<std::vector<T, InnerAllocator>, Allocator> & vector)
+{
+  size_t res = vector.capacity() * sizeof(std::vector<T, InnerAllocator>);
+  for(const auto & inner : vector) { res += bytes(inner); }
+  return res;
+}
+
+/// @brief Memory allocated by a ring buffer.
+template<typename T>
+inline size_t bytes(const boost::circular_buffer<T> & buffer)
+{
+  return buffer.capacity() * sizeof(T);
+}
+
+/// @brief Memory allocated by a dynamic-size Eigen matrix or vector. Fixed-size ones are counted in their owner.
+template<typename Derived>
+inline size_t bytes(const Eigen::PlainObjectBase<Derived> & matrix)
+{
+  if(Derived::SizeAtCompileTime != Eigen::Dynamic) { return 0; }
+  return static_cast<size_t>(matrix.size()) * sizeof(typename Derived::Scalar);
+}
+
+/// @brief Approximate memory held by a robot: multibody, configuration and sensors.
+size_t bytes(const mc_rbdyn::Robot & robot);
+
+/// @brief Approximate memory held by a set of robots.
+size_t bytes(const mc_rbdyn::Robots & robots);
+
+/// @brief Approximate memory held by a set of robots, 0 if not allocated.
+inline size_t bytes(const std::shared_ptr<mc_rbdyn::Robots> & robots)
+{
+  return robots ? bytes(*robots) : 0;
+}
+
+/// @brief Memory held by the major components of an observer.
+class MemoryReport
+{
+public:
+  /// @brief Function estimating the number of bytes held by a component.
+  using Estimator = std::function<size_t()>;
+
+  /// @brief Declares a component. Must be called before addToLogger and addToGUI.
+  /// @param component Name of the component, used in the names of the log entries and in the GUI.
+  /// @param estimator Function estimating the memory held by the component, called at each refresh.
+  void add(const std::string & component, Estimator estimator);
+
+  /// @brief Removes all the components.
+  void clear();
+
+  /// @brief Estimates again the memory held by each component. Must not be called while the observer is running on
+  /// another thread.
+  void refresh();
+
+  /// @brief Memory held by all the components at the last refresh (in bytes).
+  inline size_t total() const noexcept { return total_; }
+
+  /// @brief Adds the memory held by each component and the total (in bytes) to the logs.
+  void addToLogger(mc_rtc::Logger & logger, const std::string & category);
+
+  /// @brief Removes the entries added by addToLogger.
+  void removeFromLogger(mc_rtc::Logger & logger, const std::string & category);
+
+  /// @brief Adds the memory held by each component (in kB) and a button refreshing the report to the GUI.
+  /// @param gui GUI of the controller.
+  /// @param category Category of the observer in the GUI, the report is added to a "Memory" subcategory.
+  /// @param refresh Called when the button is pressed, must refresh the report.
+  void addToGUI(mc_rtc::gui::StateBuilder & gui, std::vector<std::string> category, std::function<void()> refresh);
+
+private:
+  struct Component
+  {
+    std::string name;
+    Estimator estimator;
+    // memory held at the last refresh
+    size_t bytes = 0;
+  };
+
+  std::vector<Component> components_;
+  size_t total_ = 0;
+};
+
+} // namespace memoryTools
+} // namespace mc_state_observation
@@ -0,0 +1,112 @@
+/**
+ * \file      noiseTools.h
+ * \brief      Reproducible injection of noise, delay and dropouts on simulated measurements.
+ *
+ * \details
+ * The engine is owned by the observer and seeded once, either from the configuration (reproducible runs) or from
+ * std::random_device (the seed used is logged so the run can be reproduced). The noise of a pose is drawn at once for
+ * its 6 components. The delay line and the dropouts allow to stress the estimators with realistic degraded
+ * measurements.
+ */
+
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+#include <SpaceVecAlg/SpaceVecAlg>
+#include <boost/circular_buffer.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace mc_state_observation
+{
+namespace noiseTools
+{
+
+/// @brief Random generator producing the noise and dropouts of simulated measurements.
+class NoiseEngine
+{
+public:
+  using Vector6 = Eigen::Matrix<double, 6, 1>;
+
+  /// @brief Reads the seed from the configuration ("seed" entry). If missing, a random seed is used.
+  /// @param config Configuration of the noise.
+  /// @param owner Name of the observer owning the engine, used in the logs.
+  void configure(const mc_rtc::Configuration & config, const std::string & owner);
+
+  /// @brief Seeds the engine.
+  void seed(uint64_t seed);
+
+  /// @brief Returns the seed of the engine.
+  inline uint64_t getSeed() const noexcept { return seed_; }
+
+  /// @brief Draws a vector whose components are uniformly distributed between the ones of the given bounds.
+  template<typename Derived>
+  typename Derived::PlainObject uniform(const Eigen::MatrixBase<Derived> & lower,
+                                        const Eigen::MatrixBase<Derived> & upper)
+  {
+    assert(lower.size() == upper.size());
+    typename Derived::PlainObject noise(lower.size());
+    for(Eigen::Index i = 0; i < noise.size(); i++) { noise(i) = unit_(engine_); }
+    return lower + (upper - lower).cwiseProduct(noise);
+  }
+
+  /// @brief Applies a uniformly distributed noise to a pose.
+  /// @param X The pose to disturb.
+  /// @param lower Lower bounds of the noise: roll, pitch, yaw (rad) of the rotation then translation.
+  /// @param upper Upper bounds of the noise: roll, pitch, yaw (rad) of the rotation then translation.
+  sva::PTransformd applyPoseNoise(const sva::PTransformd & X, const Vector6 & lower, const Vector6 & upper);
+
+  /// @brief Returns true with the given probability.
+  inline bool drop(double probability) { return probability > 0.0 && unit_(engine_) < probability; }
+
+private:
+  uint64_t seed_ = 0;
+  std::mt19937_64 engine_;
+  std::uniform_real_distribution<double> unit_{0.0, 1.0};
+};
+
+/// @brief Delays a signal by a fixed duration, with a buffer allocated once.
+template<typename T>
+class DelayLine
+{
+public:
+  /// @brief Initializes the delay line.
+  /// @param delay Delay (in s) applied to the signal.
+  /// @param dt Sampling period of the signal.
+  void init(double delay, double dt)
+  {
+    delay_ = delay;
+    buffer_.set_capacity(static_cast<size_t>(std::ceil(delay / dt)) + 1);
+    buffer_.clear();
+  }
+
+  /// @brief Adds a new sample and returns the delayed one.
+  /// @param t Time of the sample.
+  /// @param value Value of the sample.
+  /// @param delayed Sample delayed by the configured duration, set only if the function returns true.
+  /// @return false while not enough samples were received to cover the delay.
+  bool push(double t, const T & value, T & delayed)
+  {
+    buffer_.push_back(std::make_pair(t, value));
+    if(t - buffer_.front().first < delay_ - 1e-9) { return false; }
+    delayed = buffer_.front().second;
+    return true;
+  }
+
+  inline double delay() const noexcept { return delay_; }
+
+  /// @brief Memory allocated for the delayed samples (in bytes).
+  inline size_t bufferSize() const noexcept { return buffer_.capacity() * sizeof(std::pair<double, T>); }
+
+private:
+  double delay_ = 0.0;
+  boost::circular_buffer<std::pair<double, T>> buffer_{1};
+};
+
+} // namespace noiseTools
+} // namespace mc_state_observation
@@ -0,0 +1,115 @@
+/**
+ * \file      perfCounters.h
+ * \brief      Hardware performance counters measured around the iterations of an observer.
+ *
+ * \details
+ * The counters are opened with perf_event_open (Linux only) for the thread configuring the observer, which must be the
+ * one running it. They are read at the beginning and end of each measured iteration, the difference is the cost of the
+ * iteration. The cost of the last iteration and the mean cost since the configuration are exposed in the logs, which
+ * allows to compare the effect of data layout changes on the cache misses.
+ *
+ * Configuration:
+ *    enabled: true
+ *    events: [cycles, instructions, l1dMisses, llcMisses, branchMisses]
+ *
+ * The events that cannot be opened (unsupported by the CPU or virtual machine, perf_event_paranoid too restrictive) are
+ * skipped with a warning. When disabled, a measured iteration only costs the check of a boolean.
+ */
+
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/log/Logger.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace perfCounters
+{
+
+/// @brief Group of hardware counters measuring the iterations of an observer.
+class PerfCounters
+{
+public:
+  PerfCounters() = default;
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters & operator=(const PerfCounters &) = delete;
+
+  /// @brief Opens the counters given in the configuration, if enabled. Must be called from the thread running the
+  /// observer.
+  /// @param config Configuration of the counters.
+  /// @param owner Name of the observer owning the counters, used in the logs.
+  void configure(const mc_rtc::Configuration & config, const std::string & owner);
+
+  /// @brief Indicates if at least one counter is measured.
+  inline bool enabled() const noexcept { return enabled_; }
+
+  /// @brief Beginning of a measured iteration.
+  inline void start()
+  {
+    if(enabled_) { read(startValues_); }
+  }
+
+  /// @brief End of a measured iteration.
+  inline void stop()
+  {
+    if(enabled_) { accumulate(); }
+  }
+
+  /// @brief Adds the cost of the last iteration and the mean cost of the iterations of each counter to the logs.
+  void addToLogger(mc_rtc::Logger & logger, const std::string & category);
+
+  /// @brief Removes the entries added by addToLogger.
+  void removeFromLogger(mc_rtc::Logger & logger, const std::string & category);
+
+private:
+  /// @brief Reads the current values of the counters.
+  void read(std::vector<uint64_t> & values);
+
+  /// @brief Reads the counters at the end of the iteration and updates the costs.
+  void accumulate();
+
+  /// @brief Closes the counters.
+  void close();
+
+private:
+  bool enabled_ = false;
+  // file descriptor of the group leader, used to read all the counters at once
+  int leaderFd_ = -1;
+  std::vector<int> fds_;
+  // names of the measured events, in the reading order
+  std::vector<std::string> names_;
+
+  // buffer receiving the values read from the group
+  std::vector<uint64_t> readBuffer_;
+  std::vector<uint64_t> startValues_;
+  std::vector<uint64_t> stopValues_;
+  // cost of the last iteration
+  std::vector<double> last_;
+  // sum of the costs of all the iterations
+  std::vector<double> total_;
+  // number of measured iterations
+  uint64_t iterations_ = 0;
+};
+
+/// @brief Measures the counters during its scope.
+class Scope
+{
+public:
+  explicit Scope(PerfCounters & counters) : counters_(counters) { counters_.start(); }
+  ~Scope() { counters_.stop(); }
+
+  Scope(const Scope &) = delete;
+  Scope & operator=(const Scope &) = delete;
+
+private:
+  PerfCounters & counters_;
+};
+
+} // namespace perfCounters
+} // namespace mc_state_observation
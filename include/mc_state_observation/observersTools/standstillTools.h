@@ -0,0 +1,128 @@
+/**
+ * \file      standstillTools.h
+ * \brief      Detection of the static phases of the robot, used to throttle the observers.
+ *
+ * \details
+ * During long static phases (robot standing, manipulation with a steady posture), running the full estimation at
+ * every iteration is wasted computation. The detector tracks the moving variance of the gyrometers, accelerometers,
+ * encoders and force sensors measurements. The standstill is confirmed once all the standard deviations stay below
+ * their threshold for the confirmation duration. It is left immediately if a variance exceeds its threshold or if a
+ * single measurement deviates from the moving mean by more than deviationFactor times the threshold (motion or contact
+ * change).
+ *
+ * During a confirmed standstill, the observer runs its full estimation only once every correctionPeriod iterations
+ * (see throttle()).
+ *
+ * Configuration:
+ *    enabled: true
+ *    window: 0.2              # [s] time constant of the moving mean and variance
+ *    confirmationDuration: 0.5  # [s]
+ *    correctionPeriod: 10     # [iterations]
+ *    deviationFactor: 5
+ *    thresholds:              # standard deviations
+ *      gyrometer: 0.005       # [rad/s]
+ *      accelerometer: 0.05    # [m/s^2]
+ *      encoders: 1e-4         # [rad]
+ *      force: 2.0             # [N]
+ *      torque: 0.5            # [N.m]
+ */
+
+#pragma once
+
+#include <mc_rbdyn/Robot.h>
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/log/Logger.h>
+
+#include <array>
+#include <string>
+
+namespace mc_state_observation
+{
+namespace standstillTools
+{
+
+/// @brief Detects the static phases of a robot from the variance of its measurements.
+class StandstillDetector
+{
+public:
+  /// @brief Monitored signals.
+  enum Signal
+  {
+    gyrometer = 0,
+    accelerometer,
+    encoders,
+    force,
+    torque,
+    nbSignals
+  };
+
+  /// @brief Reads the configuration.
+  /// @param config Configuration of the detector.
+  /// @param owner Name of the observer, used in the logs.
+  /// @param dt Time step of the observer.
+  void configure(const mc_rtc::Configuration & config, const std::string & owner, double dt);
+
+  /// @brief Indicates if the detector is used.
+  inline bool enabled() const noexcept { return enabled_; }
+
+  /// @brief Restarts the detection, the robot is considered as moving.
+  void reset();
+
+  /// @brief Adds the measurements of the current iteration and updates the detection.
+  /// @param robot Robot whose sensors and encoders are monitored.
+  void update(const mc_rbdyn::Robot & robot);
+
+  /// @brief Indicates if the standstill is confirmed.
+  inline bool standstill() const noexcept { return standstill_; }
+
+  /// @brief Indicates if the full estimation can be skipped at the current iteration. Must be called once per
+  /// iteration, after update(). Returns false at the iterations of the full estimation (one every correctionPeriod
+  /// iterations during a standstill, every iteration otherwise).
+  bool throttle();
+
+  /// @brief Adds the standstill state and the standard deviations of the signals to the logs.
+  void addToLogger(mc_rtc::Logger & logger, const std::string & category);
+
+  /// @brief Removes the entries added by addToLogger.
+  void removeFromLogger(mc_rtc::Logger & logger, const std::string & category);
+
+private:
+  /// @brief Moving mean and variance of the components of a signal.
+  struct MovingVariance
+  {
+    /// @brief Adds a sample. Returns the maximum deviation of its components from the mean, before the update.
+    double add(const Eigen::Ref<const Eigen::VectorXd> & sample, double alpha);
+
+    Eigen::VectorXd mean;
+    Eigen::VectorXd variance;
+  };
+
+private:
+  bool enabled_ = false;
+  std::string owner_;
+
+  // weight of the new sample in the moving mean and variance
+  double alpha_ = 0.025;
+  // number of iterations required to confirm the standstill
+  int confirmationIters_ = 100;
+  // number of iterations between two full estimations during the standstill
+  int correctionPeriod_ = 10;
+  // deviation of a single measurement from the mean (relative to the threshold) leaving immediately the standstill
+  double deviationFactor_ = 5.0;
+  std::array<double, nbSignals> thresholds_ = {0.005, 0.05, 1e-4, 2.0, 0.5};
+
+  std::array<MovingVariance, nbSignals> signals_;
+  // maximum standard deviation of the components of each signal
+  std::array<double, nbSignals> stdDevs_ = {0.0, 0.0, 0.0, 0.0, 0.0};
+  // measurements of the current iteration, stacked per signal
+  std::array<Eigen::VectorXd, nbSignals> samples_;
+
+  // number of consecutive iterations without motion
+  int stillIters_ = 0;
+  bool standstill_ = false;
+  // iterations since the last full estimation
+  int skippedIters_ = 0;
+};
+
+} // namespace standstillTools
+} // namespace mc_state_observation
@@ -0,0 +1,74 @@
+/**
+ * \file      threadTools.h
+ * \brief      Placement, scheduling and naming of the background threads created by the observers.
+ *
+ * \details
+ * The background threads (ROS spinners, dump of the flight recorder, worker pools, ...) must not preempt the real-time
+ * control thread. Each of them can be given a name, a set of CPUs and a scheduling policy and priority, applied by the
+ * thread itself when it starts. The effective settings are read back from the system and logged, so a missing
+ * permission (CAP_SYS_NICE for real-time policies) is visible.
+ *
+ * Configuration of a thread:
+ *    name: spinner       # at most 15 characters
+ *    cpus: [2, 3]        # empty: no affinity
+ *    policy: other       # other, batch, idle, fifo or rr
+ *    priority: 0         # only used by the fifo and rr policies
+ */
+
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mc_state_observation
+{
+namespace threadTools
+{
+
+/// @brief Placement and scheduling of a background thread.
+struct ThreadConfiguration
+{
+  ThreadConfiguration() = default;
+  explicit ThreadConfiguration(const std::string & name) : name_(name) {}
+
+  /// @brief Reads the configuration, the missing entries keep their current value.
+  /// @param config Configuration of the thread.
+  void load(const mc_rtc::Configuration & config);
+
+  // name of the thread
+  std::string name_;
+  // CPUs on which the thread is allowed to run. If empty, the affinity is not modified.
+  std::vector<unsigned int> cpus_;
+  // scheduling policy
+  std::string policy_ = "other";
+  // scheduling priority, used by the real-time policies only
+  int priority_ = 0;
+};
+
+/// @brief Applies the configuration to the calling thread and logs the effective settings.
+/// @param config Configuration to apply.
+/// @param owner Name of the object owning the thread, used in the logs.
+/// @return false if one of the settings could not be applied.
+bool applyToCurrentThread(const ThreadConfiguration & config, const std::string & owner);
+
+/// @brief Starts a thread that applies the configuration before running the given function.
+/// @param config Configuration of the thread.
+/// @param owner Name of the object owning the thread, used in the logs.
+/// @param f Function executed by the thread.
+template<typename Function>
+std::thread startThread(const ThreadConfiguration & config, const std::string & owner, Function && f)
+{
+  return std::thread(
+      [config, owner, f = std::forward<Function>(f)]() mutable
+      {
+        applyToCurrentThread(config, owner);
+        f();
+      });
+}
+
+} // namespace threadTools
+} // namespace mc_state_observation
@@ -0,0 +1,118 @@
+/**
+ * \file      traceTools.h
+ * \brief      Timeline of the execution of the observers, exported in the Chrome trace-event format.
+ *
+ * \details
+ * MCSO_TRACE_SCOPE(name) records the beginning and end of the enclosing scope (run/update of the observers and their
+ * internal stages, iterations of the background threads). The events are stored in a ring buffer per thread, so only
+ * the last events of each thread are kept. The buffers are allocated when the tracing is enabled and claimed without
+ * lock nor allocation by the threads at their first event, then released when it is disabled. When a dump is requested
+ * (GUI, deadline miss), the recording is paused and a background thread writes the content of all the buffers to a
+ * JSON file that can be opened in a timeline viewer (chrome://tracing, Perfetto).
+ *
+ * The tracing is enabled while at least one Session is started, so each observer only keeps it enabled during its own
+ * lifetime. When the tracing is disabled, a traced scope only costs the check of an atomic flag.
+ */
+
+#pragma once
+
+#include <mc_state_observation/observersTools/threadTools.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace mc_state_observation
+{
+namespace traceTools
+{
+
+/// @brief Keeps the recording of the events enabled while it is started. The buffers are allocated by the first started
+/// session, with its settings, and released when the last one is stopped.
+class Session
+{
+public:
+  Session() = default;
+
+  ~Session() { stop(); }
+
+  Session(const Session &) = delete;
+  Session & operator=(const Session &) = delete;
+
+  /// @brief Starts the session, enabling the recording of the events if it is the first one. Does nothing if already
+  /// started.
+  /// @param owner Name of the object owning the session, used in the logs.
+  /// @param directory Directory in which the traces are dumped.
+  /// @param eventsPerThread Number of events kept for each thread.
+  /// @param maxThreads Number of threads whose events can be recorded, the events of the other ones are ignored.
+  /// @param threadConfig Placement and scheduling of the thread writing the traces.
+  void start(const std::string & owner,
+             const std::string & directory,
+             size_t eventsPerThread = 16384,
+             size_t maxThreads = 8,
+             const threadTools::ThreadConfiguration & threadConfig = threadTools::ThreadConfiguration("traceWriter"));
+
+  /// @brief Stops the session, disabling the recording of the events and releasing the buffers if it was the last one.
+  void stop();
+
+  /// @brief Indicates if the session is started.
+  inline bool started() const noexcept { return started_; }
+
+private:
+  bool started_ = false;
+};
+
+/// @brief Indicates if the events are recorded.
+bool enabled() noexcept;
+
+/// @brief Requests the dump of the events of all the threads. Can be called from the real-time thread.
+/// @param reason Reason of the dump, appended to the file name. Must point to a string with static storage.
+/// @return false if a dump is already ongoing or if the tracing is disabled.
+bool requestDump(const char * reason);
+
+/// @brief Current time of the tracing clock (in ns).
+inline uint64_t now() noexcept
+{
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+/// @brief Records an event of the calling thread.
+/// @param name Name of the event. Must point to a string with static storage.
+/// @param begin Beginning of the event (in ns).
+/// @param end End of the event (in ns).
+void record(const char * name, uint64_t begin, uint64_t end) noexcept;
+
+/// @brief Records the duration of its scope as an event.
+class Scope
+{
+public:
+  explicit Scope(const char * name) noexcept : name_(name), active_(enabled())
+  {
+    if(active_) { begin_ = now(); }
+  }
+
+  ~Scope()
+  {
+    if(active_) { record(name_, begin_, now()); }
+  }
+
+  Scope(const Scope &) = delete;
+  Scope & operator=(const Scope &) = delete;
+
+private:
+  const char * name_;
+  bool active_;
+  uint64_t begin_ = 0;
+};
+
+} // namespace traceTools
+} // namespace mc_state_observation
+
+#define MCSO_TRACE_CONCAT_IMPL(A, B) A##B
+#define MCSO_TRACE_CONCAT(A, B) MCSO_TRACE_CONCAT_IMPL(A, B)
+
+/// @brief Records the duration of the enclosing scope. NAME must be a string literal.
+#define MCSO_TRACE_SCOPE(NAME) \
+  ::mc_state_observation::traceTools::Scope MCSO_TRACE_CONCAT(mcsoTraceScope_, __LINE__)(NAME)
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <mc_state_observation/observersTools/threadTools.h>
+#include <mc_state_observation/observersTools/traceTools.h>
+#include <mc_state_observation/ros.h>
+
+#include <SpaceVecAlg/Conversions.h>
+#include <SpaceVecAlg/SpaceVecAlg>
+
+#include <tf2_ros/transform_broadcaster.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace mc_state_observation
+{
+
+/** Publishes TF frames from a background thread.
+ *
+ * The control thread only stores the latest value of each frame in a mailbox. The publisher thread builds the messages
+ * and sends each frame at its own rate, if a new value was stored since its last publication. Storing a value never
+ * blocks: if the publisher thread is reading the mailbox, the value is dropped and the next one is used.
+ */
+class TfPublisher
+{
+public:
+  explicit TfPublisher(tf2_ros::TransformBroadcaster & broadcaster) : broadcaster_(broadcaster) {}
+
+  ~TfPublisher() { stop(); }
+
+  TfPublisher(const TfPublisher &) = delete;
+  TfPublisher & operator=(const TfPublisher &) = delete;
+
+  /** Declares a frame published by this publisher. Must be called before start().
+   *
+   * @param parent Name of the parent frame
+   * @param child Name of the child frame
+   * @param rate Publication rate (in Hz)
+   *
+   * @return Index of the frame, to use with set()
+   */
+  size_t addFrame(const std::string & parent, const std::string & child, double rate)
+  {
+    auto & frame = frames_.emplace_back();
+    frame.parent = parent;
+    frame.child = child;
+    frame.period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(rate, 1e-3)));
+    return frames_.size() - 1;
+  }
+
+  /** Stores the latest value of a frame. Can be called from the real-time thread. */
+  void set(size_t frame, const sva::PTransformd & X)
+  {
+    auto & mailbox = frames_[frame];
+    std::unique_lock<std::mutex> lock(mailbox.mutex, std::try_to_lock);
+    if(!lock.owns_lock()) { return; }
+    mailbox.X = X;
+    mailbox.fresh = true;
+  }
+
+  /** Starts the publisher thread.
+   *
+   * @param config Placement and scheduling of the thread
+   * @param owner Name of the observer owning the publisher, used in the logs
+   */
+  void start(const threadTools::ThreadConfiguration & config, const std::string & owner)
+  {
+    if(frames_.empty() || thread_.joinable()) { return; }
+    stop_ = false;
+    thread_ = threadTools::startThread(config, owner, [this]() { publishLoop(); });
+  }
+
+  /** Stops the publisher thread */
+  void stop()
+  {
+    stop_ = true;
+    if(thread_.joinable()) { thread_.join(); }
+  }
+
+private:
+  struct Frame
+  {
+    std::string parent;
+    std::string child;
+    std::chrono::steady_clock::duration period;
+    std::chrono::steady_clock::time_point nextPublication;
+
+    std::mutex mutex;
+    sva::PTransformd X = sva::PTransformd::Identity();
+    bool fresh = false;
+  };
+
+  void publishLoop()
+  {
+    while(!stop_ && ros_ok())
+    {
+      auto now = std::chrono::steady_clock::now();
+      auto wakeUp = now + std::chrono::milliseconds(100);
+      for(auto & frame : frames_)
+      {
+        if(now >= frame.nextPublication) { publish(frame, now); }
+        wakeUp = std::min(wakeUp, frame.nextPublication);
+      }
+      std::this_thread::sleep_until(wakeUp);
+    }
+  }
+
+  void publish(Frame & frame, const std::chrono::steady_clock::time_point & now)
+  {
+    frame.nextPublication = now + frame.period;
+
+    MCSO_TRACE_SCOPE("TfPublisher::publish");
+    sva::PTransformd X;
+    {
+      std::lock_guard<std::mutex> lock(frame.mutex);
+      if(!frame.fresh) { return; }
+      X = frame.X;
+      frame.fresh = false;
+    }
+
+    auto transform = tf2::eigenToTransform(sva::conversions::toAffine(X));
+    transform.header.stamp = RosTimeNow();
+    transform.header.frame_id = frame.parent;
+    transform.child_frame_id = frame.child;
+    broadcaster_.sendTransform(transform);
+  }
+
+private:
+  tf2_ros::TransformBroadcaster & broadcaster_;
+  // std::deque keeps the references to the frames valid, the mailboxes cannot be moved
+  std::deque<Frame> frames_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+} // namespace mc_state_observation
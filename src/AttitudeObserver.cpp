@@ -40,6 +40,7 @@ void AttitudeObserver::configure(const mc_control::MCController & ctl, const mc_
   defaultConfig_ = config("KalmanFilter", KalmanFilterConfig{});
   config_ = defaultConfig_;
   desc_ = fmt::format("{} (sensor={})", name_, imuSensor_);
+  if(config.has("golden")) { golden_.configure(config("golden"), name()); }
 }
 
 void AttitudeObserver::reset(const mc_control::MCController & ctl)
@@ -74,6 +75,7 @@ void AttitudeObserver::reset(const mc_control::MCController & ctl)
 
 bool AttitudeObserver::run(const mc_control::MCController & ctl)
 {
+  golden_.start();
   const auto & c = config_;
   bool ret = true;
 
@@ -137,6 +139,8 @@ bool AttitudeObserver::run(const mc_control::MCController & ctl)
   const so::Vector3 orientation(xk_.segment<3>(indexes::ori));
   m_orientation = c.offset * so::kine::rotationVectorToRotationMatrix(orientation);
 
+  golden_.stop(sva::PTransformd(Eigen::Matrix3d(m_orientation.transpose())), sva::MotionVecd::Zero());
+
   return ret;
 }
 
@@ -158,12 +162,14 @@ void AttitudeObserver::addToLogger(const mc_control::MCController &,
                        return sva::PTransformd{m_orientation.transpose(), Eigen::Vector3d::Zero()};
                      });
   if(log_kf_) { config_.addToLogger(logger, category); }
+  golden_.addToLogger(logger, category);
 }
 
 void AttitudeObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
 {
   logger.removeLogEntry(category + "_orientation");
   if(log_kf_) { config_.removeFromLogger(logger, category); }
+  golden_.removeFromLogger(logger, category);
 }
 
 void AttitudeObserver::addToGUI(const mc_control::MCController & ctl,
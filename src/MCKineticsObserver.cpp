@@ -16,11 +16,25 @@
 #include <typeinfo>
 
 #include <mc_state_observation/observersTools/kinematicsTools.h>
+#include <mc_state_observation/observersTools/traceTools.h>
 
 namespace so = stateObservation;
 
 namespace mc_state_observation
 {
+namespace
+{
+// getStateCovariance() returns a copy of the whole state covariance, the recorder reads its diagonal from the
+// covariance held by the filter instead
+struct StateCovarianceAccess : so::KalmanFilterBase
+{
+  static const so::KalmanFilterBase::Pmatrix & get(const so::KalmanFilterBase & filter)
+  {
+    return filter.*(&StateCovarianceAccess::pr_);
+  }
+};
+} // namespace
+
 MCKineticsObserver::MCKineticsObserver(const std::string & type, double dt)
 : mc_observers::Observer(type, dt), observer_(4, 2)
 {
@@ -43,9 +57,9 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
 
   std::string typeOfOdometry = static_cast<std::string>(config("odometryType"));
 
-  if(typeOfOdometry == "flatOdometry") { odometryType_ = measurements::flatOdometry; }
-  else if(typeOfOdometry == "6dOdometry") { odometryType_ = measurements::odometry6d; }
-  else if(typeOfOdometry == "None") { odometryType_ = measurements::None; }
+  if(typeOfOdometry == "flatOdometry") { setOdometryType(measurements::flatOdometry); }
+  else if(typeOfOdometry == "6dOdometry") { setOdometryType(measurements::odometry6d); }
+  else if(typeOfOdometry == "None") { setOdometryType(measurements::None); }
   else
   {
     mc_rtc::log::error_and_throw<std::runtime_error>(
@@ -53,12 +67,43 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
   }
 
   config("withDebugLogs", withDebugLogs_);
+  config("headless", headless_);
+
+  /* Configuration of the asynchronous mode */
+
+  if(config.has("async"))
+  {
+    auto asyncConfig = config("async");
+    asyncConfig("enabled", async_);
+    asyncConfig("withAccelerometer", propagationWithAccelerometer_);
+    if(async_)
+    {
+      // the IMU samples received while the worker runs are kept in a buffer allocated once, covering the maximum lag
+      // allowed to the worker
+      const double maxLag = asyncConfig("maxLag", 0.1);
+      asyncImuSamples_.set_capacity(static_cast<size_t>(std::max(2.0, std::ceil(maxLag / ctl.timeStep))));
+      threadTools::ThreadConfiguration asyncThread("mckoUpdate");
+      if(asyncConfig.has("thread")) { asyncThread.load(asyncConfig("thread")); }
+      asyncUpdate_.start(
+          [this]()
+          {
+            MCSO_TRACE_SCOPE("KineticsObserver::update");
+            res_ = observer_.update();
+          },
+          asyncThread, observerName_);
+    }
+  }
+
+  // the debug logs read the Kinetics Observer, which may be updated by the worker thread while the logger runs in the
+  // asynchronous mode
+  if(headless_ || async_) { withDebugLogs_ = false; }
+  config("jointsKinematicsUpdatedUpstream", jointsKinematicsUpdatedUpstream_);
 
   config("withFilteredForcesContactDetection", withFilteredForcesContactDetection_);
 
   /* configuration of the contacts manager */
 
-  contactsManager_.init(observerName_, true);
+  contactsManager_.init(observerName_, true, !headless_);
 
   double contactDetectionPropThreshold = config("contactDetectionPropThreshold", 0.11);
   contactDetectionThreshold_ = robot.mass() * so::cst::gravityConstant * contactDetectionPropThreshold;
@@ -96,6 +141,7 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
     contactsManager_.initDetection(ctl, robot_, contactsDetectionMethod, contactsSensorsDisabledInit,
                                    contactDetectionThreshold_, forceSensorsAsInput_);
   }
+  selectContactsKinematicsStrategies();
 
   if(withFilteredForcesContactDetection_)
   {
@@ -115,10 +161,30 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
   observer_.setFiniteDifferenceStep(dx);
   observer_.setWithAccelerationEstimation(config("withAccelerationEstimation"));
 
-  linStiffness_ = (config("linStiffness").operator so::Vector3()).matrix().asDiagonal();
-  angStiffness_ = (config("angStiffness").operator so::Vector3()).matrix().asDiagonal();
-  linDamping_ = (config("linDamping").operator so::Vector3()).matrix().asDiagonal();
-  angDamping_ = (config("angDamping").operator so::Vector3()).matrix().asDiagonal();
+  const so::Matrix3 linStiffness = (config("linStiffness").operator so::Vector3()).matrix().asDiagonal();
+  const so::Matrix3 angStiffness = (config("angStiffness").operator so::Vector3()).matrix().asDiagonal();
+  const so::Matrix3 linDamping = (config("linDamping").operator so::Vector3()).matrix().asDiagonal();
+  const so::Matrix3 angDamping = (config("angDamping").operator so::Vector3()).matrix().asDiagonal();
+  defaultViscoElasticModel_.set(linStiffness, linDamping, angStiffness, angDamping);
+
+  // contacts can have their own visco-elastic model (hands and feet for example), the missing parameters are the
+  // default ones.
+  if(config.has("contactsFlexibilities"))
+  {
+    const auto contactsFlexibilities = config("contactsFlexibilities");
+    for(const auto & contactName : contactsFlexibilities.keys())
+    {
+      const auto contactFlexibility = contactsFlexibilities(contactName);
+      auto getParameter = [&contactFlexibility](const std::string & key, const so::Matrix3 & defaultParam)
+      {
+        if(!contactFlexibility.has(key)) { return defaultParam; }
+        return so::Matrix3((contactFlexibility(key).operator so::Vector3()).matrix().asDiagonal());
+      };
+      contactsViscoElasticModels_[contactName].set(
+          getParameter("linStiffness", linStiffness), getParameter("linDamping", linDamping),
+          getParameter("angStiffness", angStiffness), getParameter("angDamping", angDamping));
+    }
+  }
 
   zeroPose_.translation().setZero();
   zeroPose_.rotation().setIdentity();
@@ -231,8 +297,151 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
 
   invincibilityFrame_ = int(1.5 / ctl.timeStep);
 
-  ctl.gui()->addElement({observerName_},
-                        mc_rtc::gui::Button("SimulateNanBehaviour", [this]() { observer_.nanDetected_ = true; }));
+  if(!headless_)
+  {
+    ctl.gui()->addElement({observerName_},
+                          mc_rtc::gui::Button("SimulateNanBehaviour", [this]() { simulateNan_ = true; }));
+  }
+
+  /* Configuration of the flight recorder */
+
+  double flightRecorderDuration = 3.0;
+  std::string flightRecorderDirectory = "/tmp";
+  threadTools::ThreadConfiguration flightRecorderThread("flightRecorder");
+  // the recorder holds several seconds of records and a thread, it is only used if requested
+  withFlightRecorder_ = false;
+  if(config.has("flightRecorder"))
+  {
+    auto flightRecorderConfig = config("flightRecorder");
+    flightRecorderConfig("enabled", withFlightRecorder_);
+    flightRecorderConfig("duration", flightRecorderDuration);
+    flightRecorderConfig("directory", flightRecorderDirectory);
+    if(flightRecorderConfig.has("thread")) { flightRecorderThread.load(flightRecorderConfig("thread")); }
+  }
+  if(withFlightRecorder_)
+  {
+    initFlightRecorder(flightRecorderDuration, flightRecorderDirectory, ctl.timeStep, flightRecorderThread);
+    if(!headless_)
+    {
+      ctl.gui()->addElement(
+          {observerName_}, mc_rtc::gui::Button("DumpFlightRecorder", [this]() { flightRecorder_.requestDump("gui"); }));
+    }
+  }
+
+  /* Configuration of the execution trace */
+
+  if(config.has("trace"))
+  {
+    auto traceConfig = config("trace");
+    bool withTrace = false;
+    traceConfig("enabled", withTrace);
+    traceConfig("deadline", traceDeadline_);
+    if(withTrace)
+    {
+      std::string traceDirectory = "/tmp";
+      size_t eventsPerThread = 16384;
+      size_t maxThreads = 8;
+      threadTools::ThreadConfiguration traceThread("traceWriter");
+      traceConfig("directory", traceDirectory);
+      traceConfig("eventsPerThread", eventsPerThread);
+      traceConfig("maxThreads", maxThreads);
+      if(traceConfig.has("thread")) { traceThread.load(traceConfig("thread")); }
+      // the tracing stays enabled while this observer exists, or while other observers enabled it
+      traceSession_.start(observerName_, traceDirectory, eventsPerThread, maxThreads, traceThread);
+      if(!headless_)
+      {
+        ctl.gui()->addElement({observerName_},
+                              mc_rtc::gui::Button("DumpTrace", []() { traceTools::requestDump("gui"); }));
+      }
+    }
+  }
+
+  /* Configuration of the performance counters */
+
+  if(config.has("perfCounters")) { perfCounters_.configure(config("perfCounters"), observerName_); }
+
+  /* Configuration of the golden trajectory */
+
+  if(config.has("golden")) { golden_.configure(config("golden"), observerName_); }
+
+  /* Configuration of the terrain heightmap */
+
+  if(config.has("heightmap")) { heightmap_.configure(config("heightmap"), observerName_); }
+
+  /* Configuration of the throttling during the static phases */
+
+  if(config.has("standstill")) { standstill_.configure(config("standstill"), observerName_, ctl.timeStep); }
+
+  /* Configuration of the multi-rate mode */
+
+  if(config.has("multiRate"))
+  {
+    auto multiRateConfig = config("multiRate");
+    multiRateConfig("correctionPeriod", multiRatePeriod_);
+    multiRateConfig("withAccelerometer", propagationWithAccelerometer_);
+    if(multiRatePeriod_ < 1)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "[{}] The correction period of the multi-rate mode must be positive", observerName_);
+    }
+    if(multiRatePeriod_ > 1)
+    {
+      mc_rtc::log::info("[{}] The Kinetics Observer is updated at {} Hz and propagated with the IMU in between",
+                        observerName_, 1.0 / (multiRatePeriod_ * ctl.timeStep));
+    }
+  }
+
+  /* Configuration of the pre-warming of the planned contacts */
+
+  if(config.has("touchdownPrewarming"))
+  {
+    auto prewarmingConfig = config("touchdownPrewarming");
+    prewarmingConfig("enabled", withTouchdownPrewarming_);
+    prewarmingConfig("plannedContact", plannedContactEntry_);
+    prewarmingConfig("timeToLanding", timeToLandingEntry_);
+    prewarmingConfig("horizon", prewarmingHorizon_);
+  }
+
+  initMemoryReport();
+}
+
+void MCKineticsObserver::initMemoryReport()
+{
+  memoryReport_.clear();
+  memoryReport_.add("robots", [this]() { return memoryTools::bytes(my_robots_); });
+  memoryReport_.add("backupFbKinematics", [this]() { return memoryTools::bytes(koBackupFbKinematics_); });
+  memoryReport_.add("filter",
+                    [this]()
+                    {
+                      // state, covariances of the state and process, jacobians, gain and covariance of the
+                      // measurements
+                      const auto n = static_cast<size_t>(observer_.getStateSize());
+                      const auto nt = static_cast<size_t>(observer_.getStateTangentSize());
+                      const auto m = static_cast<size_t>(observer_.getMeasurementSize());
+                      return (n + 3 * nt * nt + 2 * m * nt + m * m + m) * sizeof(double);
+                    });
+  memoryReport_.add("flightRecorder", [this]() { return flightRecorder_.bufferSize(); });
+  memoryReport_.add("heightmap", [this]() { return heightmap_.bufferSize(); });
+  memoryReport_.add("imuSamples", [this]() { return memoryTools::bytes(asyncImuSamples_); });
+}
+
+void MCKineticsObserver::initFlightRecorder(double duration,
+                                            const std::string & directory,
+                                            double dt,
+                                            const threadTools::ThreadConfiguration & threadConfig)
+{
+  flightRecorderStatus_ = Eigen::VectorXd::Zero(2);
+  flightRecorderInputs_ = Eigen::VectorXd::Zero(6 * maxIMUs_ + 14 * maxContacts_ + 24);
+  flightRecorderCovDiag_ = Eigen::VectorXd::Zero(observer_.getStateTangentSize());
+
+  std::vector<flightRecorder::Block> blocks = {
+      {"status", static_cast<uint32_t>(flightRecorderStatus_.size())},
+      {"inputs", static_cast<uint32_t>(flightRecorderInputs_.size())},
+      {"state", static_cast<uint32_t>(observer_.getStateSize())},
+      {"stateCovarianceDiagonal", static_cast<uint32_t>(flightRecorderCovDiag_.size())}};
+
+  flightRecorder_.init(observerName_, directory, blocks, static_cast<size_t>(std::max(1, int(duration / dt))),
+                       threadConfig);
 }
 
 void MCKineticsObserver::setObserverCovariances()
@@ -252,6 +461,7 @@ void MCKineticsObserver::setObserverCovariances()
   observer_.setContactProcessCovarianceDefault(contactProcessCovariance_);
 
   observer_.resetProcessCovarianceMat();
+  predictionIters_ = 1;
 
   observer_.setIMUDefaultCovarianceMatrix(acceleroSensorCovariance_, gyroSensorCovariance_);
   observer_.setContactWrenchSensorDefaultCovarianceMatrix(contactSensorCovariance_);
@@ -263,8 +473,24 @@ void MCKineticsObserver::setObserverCovariances()
   observer_.setAbsoluteOriSensorDefaultCovarianceMatrix(absoluteOriSensorCovariance_);
 }
 
+void MCKineticsObserver::setPredictionIterations(int nbIters)
+{
+  if(nbIters == predictionIters_) { return; }
+  // the process covariance is currently the one of predictionIters_ iterations
+  auto & ekf = observer_.getEKF();
+  ekf.setQ(ekf.getQ() * (static_cast<double>(nbIters) / static_cast<double>(predictionIters_)));
+  observer_.setSamplingTime(dt_ * nbIters);
+  predictionIters_ = nbIters;
+}
+
 void MCKineticsObserver::reset(const mc_control::MCController & ctl)
 {
+  // the worker thread must not update the Kinetics Observer during its reset
+  asyncUpdate_.wait();
+  asyncUpdatePending_ = false;
+  asyncImuSamples_.clear();
+  memoryRefreshPending_ = false;
+
   const auto & robot = ctl.robot(robot_);
   const auto & realRobot = ctl.realRobot(robot_);
   const auto & realRobotModule = realRobot.module();
@@ -310,26 +536,39 @@ void MCKineticsObserver::reset(const mc_control::MCController & ctl)
   my_robots_ = mc_rbdyn::Robots::make();
   my_robots_->robotCopy(robot, robot.name());
   my_robots_->robotCopy(realRobot, "inputRobot");
-  ctl.gui()->addElement(
-      {"Robots"},
-      mc_rtc::gui::Robot(observerName_, [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
-  ctl.gui()->addElement({"Robots"},
-                        mc_rtc::gui::Robot("Real", [&ctl]() -> const mc_rbdyn::Robot & { return ctl.realRobot(); }));
+  if(!headless_)
+  {
+    ctl.gui()->addElement(
+        {"Robots"},
+        mc_rtc::gui::Robot(observerName_, [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+    ctl.gui()->addElement(
+        {"Robots"}, mc_rtc::gui::Robot("Real", [&ctl]() -> const mc_rbdyn::Robot & { return ctl.realRobot(); }));
+  }
 
   X_0_fb_ = robot.posW().translation();
 
+  heightmap_.resolve(ctl);
+  standstill_.reset();
+  itersSinceCorrection_ = 0;
+
+  // the propagation starts from the initial pose until the first update of the Kinetics Observer
+  so::kine::Kinematics initWorldFbKine;
+  initWorldFbKine.position = X_0_fb_.translation();
+  initWorldFbKine.orientation = so::Matrix3(X_0_fb_.rotation().transpose());
+  initWorldFbKine.linVel = so::Vector3::Zero();
+  initWorldFbKine.angVel = so::Vector3::Zero();
+  imuPropagator_.reset(initWorldFbKine, so::Vector3::Zero());
+
   initObserverStateVector(realRobot);
+
+  memoryReport_.refresh();
 }
 
-void MCKineticsObserver::addSensorsAsInputs(const mc_rbdyn::Robot & inputRobot,
-                                            const mc_rbdyn::Robot & measRobot,
-                                            so::Vector3 & inputAddtionalForce,
-                                            so::Vector3 & inputAddtionalTorque)
+void MCKineticsObserver::addSensorsAsInputs(so::Vector3 & inputAddtionalForce, so::Vector3 & inputAddtionalTorque)
 {
   for(const std::string & fsName : forceSensorsAsInput_)
   {
-    const mc_rbdyn::ForceSensor & forceSensor = measRobot.forceSensor(fsName);
-    sva::ForceVecd measuredWrench = forceSensor.worldWrenchWithoutGravity(inputRobot);
+    const sva::ForceVecd & measuredWrench = inputForceSensors_(fsName).fbWrenchWithoutGravity_;
 
     inputAddtionalForce += measuredWrench.force();
     inputAddtionalTorque += measuredWrench.moment();
@@ -338,11 +577,130 @@ void MCKineticsObserver::addSensorsAsInputs(const mc_rbdyn::Robot & inputRobot,
 
 bool MCKineticsObserver::run(const mc_control::MCController & ctl)
 {
+  const bool withDeadline = traceDeadline_ > 0.0 && traceSession_.started();
+  const uint64_t runStart = withDeadline ? traceTools::now() : 0;
+  const bool res = runIteration(ctl);
+
+  // the trace of the iterations preceding the deadline miss is dumped, once the scope of the iteration is recorded
+  if(withDeadline && static_cast<double>(traceTools::now() - runStart) * 1e-9 > traceDeadline_)
+  {
+    traceTools::requestDump("deadlineMiss");
+  }
+  return res;
+}
+
+bool MCKineticsObserver::runIteration(const mc_control::MCController & ctl)
+{
+  MCSO_TRACE_SCOPE("MCKineticsObserver::run");
+  perfCounters::Scope perfScope(perfCounters_);
+  golden_.start();
+
   const auto & robot = ctl.robot(robot_);
   const auto & realRobot = ctl.realRobot(robot_);
   auto & inputRobot = my_robots_->robot("inputRobot");
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
 
+  updateInputRobot(realRobot, inputRobot);
+
+  // The Kinetics Observer is updated only once every few iterations during a confirmed standstill, or once every
+  // correction period in the multi-rate mode. In the asynchronous mode, it is updated by the worker thread when the
+  // previous update is complete. In between, the estimation is propagated with the IMU.
+  standstill_.update(robot);
+  const bool multiRate = multiRatePeriod_ > 1;
+  const bool standstillSkip = estimationState_ == noIssue && standstill_.throttle();
+  const bool multiRateSkip = estimationState_ == noIssue && multiRate && itersSinceCorrection_ + 1 < multiRatePeriod_;
+  const bool asyncSkip = async_ && asyncUpdate_.running();
+
+  // the measurements of the force sensors are preprocessed once for the whole iteration. In the multi-rate mode, the
+  // update uses the latest samples, the ones of the skipped iterations are only used by the propagation.
+  if(!standstillSkip && !multiRateSkip) { inputForceSensors_.update(robot, inputRobot); }
+
+  const imuPropagation::ImuSample currentImuSample = async_ || standstillSkip || multiRateSkip
+                                                         ? imuSample(robot, inputRobot, ctl.timeStep)
+                                                         : imuPropagation::ImuSample();
+  // in the asynchronous mode, the measurements are kept until the estimation they follow is available
+  if(async_) { pushAsyncImuSample(currentImuSample); }
+
+  if(standstillSkip || multiRateSkip || asyncSkip)
+  {
+    MCSO_TRACE_SCOPE("MCKineticsObserver::propagateEstimation");
+    // the contacts are not detected, but the force sensors measurements shared with the other observers must follow the
+    // iterations of the controller
+    contactsManager_.newIteration(ctl, robot_);
+    imuPropagator_.propagate(currentImuSample, propagationWithAccelerometer());
+    publishEstimation(imuPropagator_.worldFbKine());
+    // the backup buffer must stay aligned with the one of the Tilt Observer, which is filled at every iteration
+    koBackupFbKinematics_.push_back(imuPropagator_.worldFbKine());
+    itersSinceCorrection_++;
+    finishIteration(ctl);
+    return true;
+  }
+
+  if(async_)
+  {
+    // the update started on the worker thread at a previous iteration is complete
+    const bool firstUpdate = !asyncUpdatePending_;
+    if(asyncUpdatePending_)
+    {
+      processResult(ctl, robot, inputRobot, logger);
+      forwardPredict();
+      // the processing of an error moves the floating base of the input robot
+      if(estimationState_ != noIssue) { updateInputRobot(realRobot, inputRobot); }
+    }
+    // the worker is idle, the refresh requested from the gui in the meantime can estimate the memory it holds
+    if(memoryRefreshPending_)
+    {
+      memoryReport_.refresh();
+      memoryRefreshPending_ = false;
+    }
+    // the worker is idle, the new contacts are added with the process covariance of a single iteration
+    setPredictionIterations(1);
+    setInputs(ctl, robot, inputRobot, logger);
+    // the result of the update is recorded once available, with the inputs of this iteration
+    if(withFlightRecorder_) { captureFlightInputs(robot, logger.t()); }
+    if(firstUpdate)
+    {
+      // no estimation is available yet, the propagation and the backup start from the initial state of the Kinetics
+      // Observer, given its inputs
+      so::kine::Kinematics fbFb;
+      fbFb.setZero<so::Matrix3>(so::kine::Kinematics::Flags::all);
+      imuPropagator_.reset(observer_.getGlobalKinematicsOf(fbFb), so::Vector3::Zero());
+      publishEstimation(imuPropagator_.worldFbKine());
+      koBackupFbKinematics_.push_back(imuPropagator_.worldFbKine());
+    }
+    applySimulatedNan();
+    // the prediction covers all the iterations elapsed since the last update
+    setPredictionIterations(itersSinceCorrection_ + 1);
+    itersSinceCorrection_ = 0;
+    asyncImuSamples_.clear();
+    asyncUpdate_.launch();
+    asyncUpdatePending_ = true;
+    finishIteration(ctl);
+    return true;
+  }
+
+  setInputs(ctl, robot, inputRobot, logger);
+  if(withFlightRecorder_) { captureFlightInputs(robot, logger.t()); }
+  applySimulatedNan();
+
+  {
+    MCSO_TRACE_SCOPE("KineticsObserver::update");
+    // the prediction covers all the iterations elapsed since the last full estimation
+    setPredictionIterations(itersSinceCorrection_ + 1);
+    res_ = observer_.update();
+    setPredictionIterations(1);
+    itersSinceCorrection_ = 0;
+  }
+
+  processResult(ctl, robot, inputRobot, logger);
+
+  finishIteration(ctl);
+
+  return true;
+} // namespace mc_state_observation
+
+void MCKineticsObserver::updateInputRobot(const mc_rbdyn::Robot & realRobot, mc_rbdyn::Robot & inputRobot)
+{
   inputRobot.mbc() = realRobot.mbc();
   inputRobot.mb() = realRobot.mb();
 
@@ -352,7 +710,13 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
   inputRobot.posW(zeroPose_);
   inputRobot.velW(zeroMotion_);
   inputRobot.accW(zeroMotion_);
+}
 
+void MCKineticsObserver::setInputs(const mc_control::MCController & ctl,
+                                   const mc_rbdyn::Robot & robot,
+                                   const mc_rbdyn::Robot & inputRobot,
+                                   mc_rtc::Logger & logger)
+{
   /** Center of mass (assumes FK, FV and FA are already done)
       Must be initialized now as used for the conversion from user to centroid frame !!! **/
   worldCoMKine_.position = inputRobot.com();
@@ -366,14 +730,21 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
    * force sensor and not the contact surface!
    */
   // retrieves the list of contacts and set simStarted to true once a contact is detected
-  updateContacts(ctl, findNewContacts(ctl), logger);
+  {
+    MCSO_TRACE_SCOPE("MCKineticsObserver::updateContacts");
+    if(withTouchdownPrewarming_) { prewarmPlannedContact(ctl, logger); }
+    updateContacts(ctl, findNewContacts(ctl), logger);
+  }
 
   // force measurements from sensor that are not associated to a currently set contact are given to the Kinetics
   // Observer as inputs.
-  inputAdditionalWrench(inputRobot, robot);
+  inputAdditionalWrench();
 
   /** Accelerometers **/
-  updateIMUs(robot, inputRobot);
+  {
+    MCSO_TRACE_SCOPE("MCKineticsObserver::updateIMUs");
+    updateIMUs(robot, inputRobot);
+  }
 
   /*
   so::kine::Orientation oriMeasurement;
@@ -389,10 +760,13 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
 
   observer_.setCoMInertiaMatrix(so::Matrix3(
       inertiaWaist_.inertia() + observer_.getMass() * so::kine::skewSymmetric2(observer_.getCenterOfMass()())));
-  /* Step once, and return result */
-
-  res_ = observer_.update();
+}
 
+void MCKineticsObserver::processResult(const mc_control::MCController & ctl,
+                                       const mc_rbdyn::Robot & robot,
+                                       mc_rbdyn::Robot & inputRobot,
+                                       mc_rtc::Logger & logger)
+{
   // Kinematics of the floating base in the real world frame (our estimation goal)
   so::kine::Kinematics mcko_K_0_fb;
 
@@ -400,6 +774,9 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
   else if(invincibilityIter_ > 0 && invincibilityIter_ < invincibilityFrame_) { estimationState_ = invincibilityFrame; }
   else { estimationState_ = noIssue; }
 
+  // the record is made before handling a possible error, so the faulty state is part of the dump
+  if(withFlightRecorder_) { recordFlight(); }
+
   // if no anomaly is detected and if we aren't in the "invicibility frame", we update the floating base with the
   // results of the Kinetics Observer
   switch(estimationState_)
@@ -427,6 +804,19 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
 
       a_fb_0_.angular() = mcko_K_0_fb.angAcc();
       a_fb_0_.linear() = mcko_K_0_fb.linAcc();
+
+      if(standstill_.enabled() || multiRatePeriod_ > 1 || async_)
+      {
+        // the propagation uses the gyrometer bias estimated by the last full estimation
+        so::Vector3 gyroBias = so::Vector3::Zero();
+        if(withGyroBias_)
+        {
+          const auto imuIndex = mapIMUs_.getNumFromName(IMUs_[0].name());
+          gyroBias =
+              observer_.getCurrentStateVector().segment(observer_.gyroBiasIndex(imuIndex), observer_.sizeGyroBias);
+        }
+        imuPropagator_.reset(mcko_K_0_fb, gyroBias);
+      }
       break;
     }
     case invincibilityFrame:
@@ -456,6 +846,8 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
       {
         update(inputRobot);
         inputRobot.forwardKinematics();
+        // the tilt of the robot changed so the contribution of the gravity to the measurements changed too
+        inputForceSensors_.update(robot, inputRobot);
         so::kine::Kinematics fbFb; // "Zero" Kinematics
         fbFb.setZero<so::Matrix3>(so::kine::Kinematics::Flags::all);
         so::kine::Kinematics newWorldCentroidKine;
@@ -473,18 +865,8 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
           KoContactWithSensor contact = contactsManager_.contactWithSensor(contactIndex);
 
           // Update of the force measurements (the contribution of the gravity changed)
-          const mc_rbdyn::ForceSensor & forceSensor = robot.forceSensor(contact.forceSensorName());
-
-          // the tilt of the robot changed so the contribution of the gravity to the measurements changed too
-          if(KoContactsManager().getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
-          {
-            updateContactForceMeasurement(contact, forceSensor.wrenchWithoutGravity(inputRobot));
-          }
-          else // the kinematics of the contact are the ones of the associated surface
-          {
-            updateContactForceMeasurement(contact, contact.surfaceSensorKine_,
-                                          forceSensor.wrenchWithoutGravity(inputRobot));
-          }
+          (this->*contactForceMeasurementUpdater_)(
+              contact, inputForceSensors_(contact.forceSensorName()).wrenchWithoutGravity_);
 
           so::kine::Kinematics newWorldContactKineRef;
 
@@ -500,19 +882,20 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
     {
       // an error was just detected, we reset the state vector and covariances and start the invicibility frame, during
       // which we let the Kinetics Observer converge before using it again.
-      auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
       if(logger.t() / ctl.timeStep < backupIterInterval_)
       {
-        mc_rtc::log::warning("The backup function was called before the required time was ellapsed. The backup will be "
-                             "performed using the last {} seconds",
-                             logger.t());
+        MCSO_LOG_RATE_LIMITED(warning, 1.0,
+                              "The backup function was called before the required time was ellapsed. The backup will "
+                              "be performed using the last {} seconds",
+                              logger.t());
       }
 
       if(logger.t() / ctl.timeStep - lastBackupIter_ < backupIterInterval_)
       {
-        mc_rtc::log::warning("The backup function was called again too quickly. The backup will be "
-                             "performed using the last {} seconds",
-                             logger.t() - lastBackupIter_ * ctl.timeStep);
+        MCSO_LOG_RATE_LIMITED(warning, 1.0,
+                              "The backup function was called again too quickly. The backup will be "
+                              "performed using the last {} seconds",
+                              logger.t() - lastBackupIter_ * ctl.timeStep);
       }
 
       auto & datastore = (const_cast<mc_control::MCController &>(ctl)).datastore();
@@ -520,7 +903,10 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
       // observer already contains the last estimation of the floating base so we prevent a disalignment of the two
       // buffers. This empty Kinematics is filled and returned by the "runBackup" function.
       koBackupFbKinematics_.push_back(so::kine::Kinematics::zeroKinematics(so::kine::Kinematics::Flags::pose));
-      mcko_K_0_fb = datastore.call<const so::kine::Kinematics>("runBackup");
+      {
+        MCSO_TRACE_SCOPE("MCKineticsObserver::runBackup");
+        mcko_K_0_fb = datastore.call<const so::kine::Kinematics>("runBackup");
+      }
 
       X_0_fb_.rotation() = mcko_K_0_fb.orientation.toMatrix3().transpose();
       X_0_fb_.translation() = mcko_K_0_fb.position();
@@ -535,6 +921,8 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
       // we update update robot as it will be updated at the beginning of the next iteration anyway
       update(inputRobot);
       inputRobot.forwardKinematics();
+      // the offset due to the gravity on the force measurements changed
+      inputForceSensors_.update(robot, inputRobot);
       so::kine::Kinematics newWorldCentroidKine;
       newWorldCentroidKine.position = inputRobot.com();
       newWorldCentroidKine.linVel = inputRobot.comVelocity();
@@ -552,17 +940,8 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
         KoContactWithSensor contact = contactsManager_.contactWithSensor(contactIndex);
 
         // Update of the force measurements (the offset due to the gravity changed)
-        const mc_rbdyn::ForceSensor & forceSensor = inputRobot.forceSensor(contact.forceSensorName());
-
-        so::kine::Kinematics bodySensorKine =
-            kinematicsTools::poseFromSva(forceSensor.X_p_f(), so::kine::Kinematics::Flags::vel);
-
-        so::kine::Kinematics bodySurfaceKine = kinematicsTools::poseFromSva(
-            inputRobot.surface(contact.surfaceName()).X_b_s(), so::kine::Kinematics::Flags::vel);
-
-        so::kine::Kinematics surfaceSensorKine = bodySurfaceKine.getInverse() * bodySensorKine;
-
-        updateContactForceMeasurement(contact, surfaceSensorKine, forceSensor.wrenchWithoutGravity(inputRobot));
+        (this->*contactForceMeasurementUpdater_)(contact,
+                                                 inputForceSensors_(contact.forceSensorName()).wrenchWithoutGravity_);
 
         so::kine::Kinematics newWorldContactKineRef;
 
@@ -577,6 +956,8 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
 
       observer_.nanDetected_ = false;
 
+      if(withFlightRecorder_) { flightRecorder_.requestDump("errorDetected"); }
+
       break;
     }
   }
@@ -587,15 +968,84 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
     correctedMeasurements_ = observer_.getEKF().getSimulatedMeasurement(observer_.getEKF().getCurrentTime());
     globalCentroidKinematics_ = observer_.getGlobalCentroidKinematics();
   }
+}
+
+void MCKineticsObserver::applySimulatedNan()
+{
+  // requested from the gui, applied here as the Kinetics Observer may be updated by the worker thread in the meantime
+  if(simulateNan_)
+  {
+    observer_.nanDetected_ = true;
+    simulateNan_ = false;
+  }
+}
+
+void MCKineticsObserver::forwardPredict()
+{
+  if(estimationState_ != noIssue)
+  {
+    // the backup gives the estimation at the current iteration, the next propagations start from it
+    so::kine::Kinematics worldFbKine;
+    worldFbKine.position = X_0_fb_.translation();
+    worldFbKine.orientation = so::Matrix3(X_0_fb_.rotation().transpose());
+    worldFbKine.linVel = v_fb_0_.linear();
+    worldFbKine.angVel = v_fb_0_.angular();
+    imuPropagator_.reset(worldFbKine, so::Vector3::Zero());
+    return;
+  }
+
+  MCSO_TRACE_SCOPE("MCKineticsObserver::forwardPredict");
+  // the estimation corresponds to the iteration at which the update was started, it is predicted forward to the
+  // current iteration with the measurements received since then
+  for(const auto & sample : asyncImuSamples_) { imuPropagator_.propagate(sample, propagationWithAccelerometer()); }
+  publishEstimation(imuPropagator_.worldFbKine());
+  koBackupFbKinematics_.back() = imuPropagator_.worldFbKine();
+}
 
+void MCKineticsObserver::finishIteration(const mc_control::MCController & ctl)
+{
   /* Update of the visual representation (only a visual feature) of the observed robot */
   my_robots_->robot().mbc().q = ctl.realRobot().mbc().q;
 
   /* Update of the observed robot */
   update(my_robots_->robot());
 
-  return true;
-} // namespace mc_state_observation
+  golden_.stop(X_0_fb_, v_fb_0_);
+}
+
+void MCKineticsObserver::pushAsyncImuSample(const imuPropagation::ImuSample & sample)
+{
+  if(asyncImuSamples_.full())
+  {
+    // the worker lags behind more than allowed, the two oldest samples are merged into a single propagation step
+    const double oldestDt = asyncImuSamples_.front().dt;
+    asyncImuSamples_.pop_front();
+    asyncImuSamples_.front().dt += oldestDt;
+    asyncMergedImuSamples_++;
+  }
+  asyncImuSamples_.push_back(sample);
+}
+
+imuPropagation::ImuSample MCKineticsObserver::imuSample(const mc_rbdyn::Robot & measRobot,
+                                                        const mc_rbdyn::Robot & inputRobot,
+                                                        double dt)
+{
+  // the propagation uses the first IMU
+  const auto & imu = measRobot.bodySensor(IMUs_[0].name());
+  return {imuKinematics(inputRobot, imu.name()), imu.angularVelocity(), imu.linearAcceleration(), dt};
+}
+
+void MCKineticsObserver::publishEstimation(const so::kine::Kinematics & mcko_K_0_fb)
+{
+  X_0_fb_.rotation() = mcko_K_0_fb.orientation.toMatrix3().transpose();
+  X_0_fb_.translation() = mcko_K_0_fb.position();
+
+  v_fb_0_.angular() = mcko_K_0_fb.angVel();
+  v_fb_0_.linear() = mcko_K_0_fb.linVel();
+
+  a_fb_0_.angular() = mcko_K_0_fb.angAcc();
+  a_fb_0_.linear() = mcko_K_0_fb.linAcc();
+}
 
 ///////////////////////////////////////////////////////////////////////
 /// -------------------------Called functions--------------------------
@@ -615,17 +1065,48 @@ void MCKineticsObserver::initObserverStateVector(const mc_rbdyn::Robot & robot)
   observer_.setInitWorldCentroidStateVector(initStateVector);
 }
 
+void MCKineticsObserver::runBatch(mc_control::MCController & ctl,
+                                 const batchTools::InputView & inputs,
+                                 batchTools::OutputView outputs)
+{
+  if(!headless_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The batch processing requires a headless observer",
+                                                     observerName_);
+  }
+  if(async_)
+  {
+    // the result would depend on the duration of the updates on the worker thread
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] The batch processing doesn't support the asynchronous mode", observerName_);
+  }
+
+  // the run function is called without virtual dispatch, the estimation is read directly from the members
+  batchTools::runBatch(ctl, robot_, inputs, outputs, observerName_,
+                       [this, &ctl](sva::PTransformd & X, sva::MotionVecd & v)
+                       {
+                         MCKineticsObserver::run(ctl);
+                         X = X_0_fb_;
+                         v = v_fb_0_;
+                       });
+}
+
 void MCKineticsObserver::update(mc_control::MCController & ctl) // this function is called by the pipeline if the
                                                                 // update is set to true in the configuration file
 {
+  MCSO_TRACE_SCOPE("MCKineticsObserver::update");
   auto & datastore = (const_cast<mc_control::MCController &>(ctl)).datastore();
   // this function checks that the backup estimator uses the same odometry type than the Kinetics Observer
   datastore.call<>("checkCorrectBackupConf", odometryType_);
 
   auto & realRobot = ctl.realRobot(robot_);
-  update(realRobot);
-  realRobot.forwardKinematics();
-  realRobot.forwardVelocity();
+  if(jointsKinematicsUpdatedUpstream_) { kinematicsTools::updateFloatingBase(realRobot, X_0_fb_, v_fb_0_); }
+  else
+  {
+    update(realRobot);
+    realRobot.forwardKinematics();
+    realRobot.forwardVelocity();
+  }
 }
 
 // used only to update the visual representation of the estimated robot
@@ -635,7 +1116,7 @@ void MCKineticsObserver::update(mc_rbdyn::Robot & robot)
   robot.velW(v_fb_0_.vector());
 }
 
-void MCKineticsObserver::inputAdditionalWrench(const mc_rbdyn::Robot & inputRobot, const mc_rbdyn::Robot & measRobot)
+void MCKineticsObserver::inputAdditionalWrench()
 {
   additionalUserResultingForce_.setZero();
   additionalUserResultingMoment_.setZero();
@@ -649,13 +1130,13 @@ void MCKineticsObserver::inputAdditionalWrench(const mc_rbdyn::Robot & inputRobo
        && contact.sensorEnabled_) // if the contact is not set but we use the force sensor measurements,
                                   // then we give the measured force as an input to the Kinetics Observer
     {
-      sva::ForceVecd measuredWrench = measRobot.forceSensor(fsName).worldWrenchWithoutGravity(inputRobot);
+      const sva::ForceVecd & measuredWrench = inputForceSensors_(fsName).fbWrenchWithoutGravity_;
       additionalUserResultingForce_ += measuredWrench.force();
       additionalUserResultingMoment_ += measuredWrench.moment();
     }
   }
 
-  addSensorsAsInputs(inputRobot, measRobot, additionalUserResultingForce_, additionalUserResultingMoment_);
+  addSensorsAsInputs(additionalUserResultingForce_, additionalUserResultingMoment_);
 
   // We pass this computed wrench as an input to the Kinetics Observer
   observer_.setAdditionalWrench(additionalUserResultingForce_, additionalUserResultingMoment_);
@@ -670,9 +1151,9 @@ void MCKineticsObserver::inputAdditionalWrench(const mc_rbdyn::Robot & inputRobo
       const std::string & fsName = contact.forceSensorName();
       so::Vector3 forceCentroid = so::Vector3::Zero();
       so::Vector3 torqueCentroid = so::Vector3::Zero();
-      observer_.convertWrenchFromUserToCentroid(
-          measRobot.forceSensor(fsName).worldWrenchWithoutGravity(inputRobot).force(),
-          measRobot.forceSensor(fsName).worldWrenchWithoutGravity(inputRobot).moment(), forceCentroid, torqueCentroid);
+      const sva::ForceVecd & measuredWrench = inputForceSensors_(fsName).fbWrenchWithoutGravity_;
+      observer_.convertWrenchFromUserToCentroid(measuredWrench.force(), measuredWrench.moment(), forceCentroid,
+                                                torqueCentroid);
 
       contact.wrenchInCentroid_.segment<3>(0) = forceCentroid;
       contact.wrenchInCentroid_.segment<3>(3) = torqueCentroid;
@@ -680,27 +1161,89 @@ void MCKineticsObserver::inputAdditionalWrench(const mc_rbdyn::Robot & inputRobo
   }
 }
 
+so::kine::Kinematics MCKineticsObserver::imuKinematics(const mc_rbdyn::Robot & inputRobot, const std::string & imuName)
+{
+  const auto & imu = inputRobot.bodySensor(imuName);
+
+  // the IMU is fixed in its parent body: zero velocities and accelerations
+  const sva::PTransformd & bodyImuPose = imu.X_b_s();
+  const kinematicsTools::FullKinematics bodyImuKine = kinematicsTools::FullKinematics::fromSva(bodyImuPose);
+
+  const size_t parentIndex = inputRobot.bodyIndexByName(imu.parentBody());
+  const kinematicsTools::FullKinematics worldBodyKine =
+      kinematicsTools::FullKinematics::fromSva(inputRobot.mbc().bodyPosW[parentIndex],
+                                               inputRobot.mbc().bodyVelW[parentIndex],
+                                               inputRobot.mbc().bodyAccB[parentIndex], true, false);
+
+  // the kinematics are converted only at the interface with the Kinetics Observer
+  return (worldBodyKine * bodyImuKine).toKinematics();
+}
+
 void MCKineticsObserver::updateIMUs(const mc_rbdyn::Robot & measRobot, const mc_rbdyn::Robot & inputRobot)
 {
   for(const auto & imu : IMUs_)
   {
     /** Position of accelerometer **/
+    const so::kine::Kinematics fbImuKine = imuKinematics(inputRobot, imu.name());
 
-    const sva::PTransformd & bodyImuPose = inputRobot.bodySensor(imu.name()).X_b_s();
-    so::kine::Kinematics bodyImuKine =
-        kinematicsTools::poseFromSva(bodyImuPose, so::kine::Kinematics::Flags::vel | so::kine::Kinematics::Flags::acc);
+    observer_.setIMU(measRobot.bodySensor().linearAcceleration(), measRobot.bodySensor().angularVelocity(),
+                     acceleroSensorCovariance_, gyroSensorCovariance_, fbImuKine, mapIMUs_.getNumFromName(imu.name()));
+  }
+}
 
-    so::kine::Kinematics worldBodyKine = kinematicsTools::kinematicsFromSva(
-        inputRobot.mbc().bodyPosW[inputRobot.bodyIndexByName(imu.parentBody())],
-        inputRobot.mbc().bodyVelW[inputRobot.bodyIndexByName(imu.parentBody())],
-        inputRobot.mbc().bodyAccB[inputRobot.bodyIndexByName(imu.parentBody())], true, false);
+void MCKineticsObserver::captureFlightInputs(const mc_rbdyn::Robot & measRobot, double t)
+{
+  MCSO_TRACE_SCOPE("MCKineticsObserver::captureFlightInputs");
+  flightRecorderInputsTime_ = t;
 
-    so::kine::Kinematics worldImuKine = worldBodyKine * bodyImuKine;
-    const so::kine::Kinematics fbImuKine = worldImuKine;
+  // IMUs, with the measurements given in updateIMUs
+  for(const auto & imu : IMUs_)
+  {
+    const int imuNum = mapIMUs_.getNumFromName(imu.name());
+    if(imuNum >= maxIMUs_) { continue; }
+    flightRecorderInputs_.segment<3>(6 * imuNum) = measRobot.bodySensor().linearAcceleration();
+    flightRecorderInputs_.segment<3>(6 * imuNum + 3) = measRobot.bodySensor().angularVelocity();
+  }
 
-    observer_.setIMU(measRobot.bodySensor().linearAcceleration(), measRobot.bodySensor().angularVelocity(),
-                     acceleroSensorCovariance_, gyroSensorCovariance_, fbImuKine, mapIMUs_.getNumFromName(imu.name()));
+  // contacts
+  const Eigen::Index contactsOffset = 6 * maxIMUs_;
+  for(const auto & contactWithSensor : contactsManager_.contactsWithSensors())
+  {
+    const KoContactWithSensor & contact = contactWithSensor.second;
+    if(contact.getID() >= maxContacts_) { continue; }
+    auto contactInputs = flightRecorderInputs_.segment<14>(contactsOffset + 14 * contact.getID());
+    contactInputs(0) = double(contact.isSet_);
+    if(contact.isSet_)
+    {
+      contactInputs.segment<6>(1) = contact.contactWrenchVector_;
+      contactInputs.segment<3>(7) = contact.fbContactKine_.position();
+      contactInputs.segment<4>(10) = contact.fbContactKine_.orientation.toVector4();
+    }
+    else { contactInputs.tail<13>().setZero(); }
   }
+
+  // centroidal inputs
+  auto centroidalInputs = flightRecorderInputs_.tail<24>();
+  centroidalInputs.segment<3>(0) = worldCoMKine_.position();
+  centroidalInputs.segment<3>(3) = worldCoMKine_.linVel();
+  centroidalInputs.segment<3>(6) = worldCoMKine_.linAcc();
+  centroidalInputs.segment<3>(9) = observer_.getAngularMomentum()();
+  centroidalInputs.segment<3>(12) = observer_.getInertiaMatrix()().diagonal();
+  centroidalInputs.segment<2>(15) = observer_.getInertiaMatrix()().block<1, 2>(0, 1);
+  centroidalInputs(17) = observer_.getInertiaMatrix()()(1, 2);
+  centroidalInputs.segment<3>(18) = additionalUserResultingForce_;
+  centroidalInputs.segment<3>(21) = additionalUserResultingMoment_;
+}
+
+void MCKineticsObserver::recordFlight()
+{
+  MCSO_TRACE_SCOPE("MCKineticsObserver::recordFlight");
+  flightRecorderStatus_(0) = static_cast<double>(estimationState_);
+  flightRecorderStatus_(1) = static_cast<double>(observer_.getNumberOfSetContacts());
+
+  flightRecorderCovDiag_ = StateCovarianceAccess::get(observer_.getEKF()).diagonal();
+
+  flightRecorder_.record(flightRecorderInputsTime_, {&flightRecorderStatus_, &flightRecorderInputs_, &res_, &flightRecorderCovDiag_});
 }
 
 const measurements::ContactsManager<KoContactWithSensor, measurements::ContactWithoutSensor>::ContactsSet &
@@ -726,36 +1269,18 @@ const so::kine::Kinematics MCKineticsObserver::getContactWorldKinematicsAndWrenc
 
   so::kine::Kinematics worldContactKine;
 
-  const sva::PTransformd & bodyContactSensorPose = fs.X_p_f();
-  so::kine::Kinematics bodyContactSensorKine =
-      kinematicsTools::poseFromSva(bodyContactSensorPose, so::kine::Kinematics::Flags::vel);
-
-  // kinematics of the sensor's parent body in the world
-  so::kine::Kinematics worldBodyKine = kinematicsTools::poseAndVelFromSva(
-      currentRobot.mbc().bodyPosW[currentRobot.bodyIndexByName(fs.parentBody())],
-      currentRobot.mbc().bodyVelW[currentRobot.bodyIndexByName(fs.parentBody())], true);
-
   // kinematics of the frame of the force sensor in the world frame
-  so::kine::Kinematics worldSensorKine = worldBodyKine * bodyContactSensorKine;
+  so::kine::Kinematics worldSensorKine = worldSensorKinematics(contact, currentRobot, fs);
 
-  if(KoContactsManager().getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
-  {
-    // If the contact is detecting using thresholds, we will then consider the sensor frame as
-    // the contact surface frame directly.
-    worldContactKine = worldSensorKine;
-    updateContactForceMeasurement(contact, measuredWrench);
-  }
-  else // the kinematics of the contacts are the ones of the surface, but we must transport the measured wrench
-  {
-    // pose of the surface in the world / floating base's frame
-    sva::PTransformd worldSurfacePose = currentRobot.surfacePose(contact.surfaceName());
-    // Kinematics of the surface in the world / floating base's frame
-    worldContactKine = kinematicsTools::poseFromSva(worldSurfacePose, so::kine::Kinematics::Flags::vel);
+  worldContactKine = (this->*contactWorldKinematicsGetter_)(contact, currentRobot, worldSensorKine);
 
-    contact.surfaceSensorKine_ = worldContactKine.getInverse() * worldSensorKine;
-    // expressing the force measurement in the frame of the surface
-    updateContactForceMeasurement(contact, contact.surfaceSensorKine_, measuredWrench);
-  }
+  // the measured wrench must be transported if the sensor is not attached to the contact frame. Only the pose of the
+  // sensor in the surface is required.
+  contact.surfaceSensorKine_ =
+      (kinematicsTools::lazy(worldContactKine).inverse() * kinematicsTools::lazy(worldSensorKine))
+          .evaluate<kinematicsTools::staticFields::pose>()
+          .toKinematics();
+  (this->*contactForceMeasurementUpdater_)(contact, measuredWrench);
 
   return worldContactKine;
 }
@@ -774,32 +1299,65 @@ const so::kine::Kinematics MCKineticsObserver::getContactWorldKinematics(KoConta
 
   so::kine::Kinematics worldContactKine;
 
-  const sva::PTransformd & bodyContactSensorPose = fs.X_p_f();
-  so::kine::Kinematics bodyContactSensorKine =
-      kinematicsTools::poseFromSva(bodyContactSensorPose, so::kine::Kinematics::Flags::vel);
+  so::kine::Kinematics worldSensorKine = worldSensorKinematics(contact, currentRobot, fs);
+
+  worldContactKine = (this->*contactWorldKinematicsGetter_)(contact, currentRobot, worldSensorKine);
+
+  return worldContactKine;
+}
+
+so::kine::Kinematics MCKineticsObserver::worldSensorKinematics(KoContactWithSensor & contact,
+                                                               const mc_rbdyn::Robot & currentRobot,
+                                                               const mc_rbdyn::ForceSensor & fs)
+{
+  // the sensor is fixed in its parent body (zero velocities), its pose and the index of the body are computed once
+  if(contact.sensorParentIndex_ < 0)
+  {
+    contact.sensorParentIndex_ = static_cast<int>(currentRobot.bodyIndexByName(fs.parentBody()));
+    contact.parentSensorKine_ = kinematicsTools::PoseVelKinematics::fromSva(fs.X_p_f());
+  }
 
   // kinematics of the sensor's parent body in the world frame
-  so::kine::Kinematics worldBodyKine = kinematicsTools::poseAndVelFromSva(
-      currentRobot.mbc().bodyPosW[currentRobot.bodyIndexByName(fs.parentBody())],
-      currentRobot.mbc().bodyVelW[currentRobot.bodyIndexByName(fs.parentBody())], true);
+  const auto parentIndex = static_cast<size_t>(contact.sensorParentIndex_);
+  const kinematicsTools::PoseVelKinematics worldBodyKine = kinematicsTools::PoseVelKinematics::fromSva(
+      currentRobot.mbc().bodyPosW[parentIndex], currentRobot.mbc().bodyVelW[parentIndex], true);
 
-  so::kine::Kinematics worldSensorKine = worldBodyKine * bodyContactSensorKine;
+  return (worldBodyKine * contact.parentSensorKine_).toKinematics();
+}
 
-  if(KoContactsManager().getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
+void MCKineticsObserver::selectContactsKinematicsStrategies()
+{
+  // the contacts detected from thresholds on the measured forces are not associated to a surface, they take the
+  // kinematics of their force sensor
+  if(contactsManager_.getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
   {
-    // If the contact is detecting using thresholds, we will then consider the sensor frame as
-    // the contact surface frame directly.
-    worldContactKine = worldSensorKine;
+    contactWorldKinematicsGetter_ = &MCKineticsObserver::contactWorldKinematicsFromSensor;
+    contactForceMeasurementUpdater_ = &MCKineticsObserver::updateContactForceMeasurementInSensorFrame;
   }
-  else // the kinematics of the contacts are the ones of the surface.
+  else
   {
-    // pose of the surface in the world / floating base's frame
-    sva::PTransformd worldSurfacePose = currentRobot.surfacePose(contact.surfaceName());
-    // Kinematics of the surface in the world / floating base's frame
-    worldContactKine = kinematicsTools::poseFromSva(worldSurfacePose, so::kine::Kinematics::Flags::vel);
+    contactWorldKinematicsGetter_ = &MCKineticsObserver::contactWorldKinematicsFromSurface;
+    contactForceMeasurementUpdater_ = &MCKineticsObserver::updateContactForceMeasurementInSurfaceFrame;
   }
+}
 
-  return worldContactKine;
+so::kine::Kinematics MCKineticsObserver::contactWorldKinematicsFromSensor(KoContactWithSensor &,
+                                                                          const mc_rbdyn::Robot &,
+                                                                          const so::kine::Kinematics & worldSensorKine)
+{
+  // If the contact is detecting using thresholds, we will then consider the sensor frame as
+  // the contact surface frame directly.
+  return worldSensorKine;
+}
+
+so::kine::Kinematics MCKineticsObserver::contactWorldKinematicsFromSurface(KoContactWithSensor & contact,
+                                                                           const mc_rbdyn::Robot & currentRobot,
+                                                                           const so::kine::Kinematics &)
+{
+  // pose of the surface in the world / floating base's frame
+  sva::PTransformd worldSurfacePose = currentRobot.surfacePose(contact.surfaceName());
+  // Kinematics of the surface in the world / floating base's frame
+  return kinematicsTools::poseFromSva(worldSurfacePose, so::kine::Kinematics::Flags::vel);
 }
 
 void MCKineticsObserver::updateContactForceMeasurement(KoContactWithSensor & contact,
@@ -815,8 +1373,14 @@ void MCKineticsObserver::updateContactForceMeasurement(KoContactWithSensor & con
       + surfaceSensorKine.position().cross(contact.contactWrenchVector_.segment<3>(0));
 }
 
-void MCKineticsObserver::updateContactForceMeasurement(KoContactWithSensor & contact,
-                                                       const sva::ForceVecd & measuredWrench)
+void MCKineticsObserver::updateContactForceMeasurementInSurfaceFrame(KoContactWithSensor & contact,
+                                                                     const sva::ForceVecd & measuredWrench)
+{
+  updateContactForceMeasurement(contact, contact.surfaceSensorKine_, measuredWrench);
+}
+
+void MCKineticsObserver::updateContactForceMeasurementInSensorFrame(KoContactWithSensor & contact,
+                                                                    const sva::ForceVecd & measuredWrench)
 {
   // If the contact is detecting using thresholds, we will then consider the sensor frame as
   // the contact surface frame directly.
@@ -828,11 +1392,12 @@ void MCKineticsObserver::getOdometryWorldContactRest(const mc_control::MCControl
                                                      KoContactWithSensor & contact,
                                                      so::kine::Kinematics & worldContactKineRef)
 {
-  const auto & robot = ctl.robot(robot_);
   if(!contact.sensorEnabled_)
   {
-    mc_rtc::log::info("The sensor is disabled but is required for the odometry. It will be used for the odometry "
-                      "but not in the correction made by the Kinetics Observer.");
+    MCSO_LOG_RATE_LIMITED(info, 5.0,
+                          "[{}] The sensor {} is disabled but is required for the odometry. It will be used for the "
+                          "odometry but not in the correction made by the Kinetics Observer.",
+                          observerName_, contact.forceSensorName());
   }
   const so::Vector3 & contactForceMeas = contact.contactWrenchVector_.segment<3>(0); // retrieving the force measurement
   const so::Vector3 & contactTorqueMeas =
@@ -843,19 +1408,23 @@ void MCKineticsObserver::getOdometryWorldContactRest(const mc_control::MCControl
   // visco-elastic model of the contacts.
   const so::kine::Kinematics worldContactKine = observer_.getGlobalKinematicsOf(contact.fbContactKine_);
 
-  // we get the reference position of the contact by removing the contribution of the visco-elastic model
+  const ContactViscoElasticModel & model = contact.viscoElasticModel_;
+  const so::Matrix3 & worldContactOri = worldContactKine.orientation.toMatrix3();
+
+  // we get the reference position of the contact by removing the contribution of the visco-elastic model. Only
+  // matrix-vector products are performed, the compliance being stored in the model.
   worldContactKineRef.position =
-      worldContactKine.orientation.toMatrix3() * linStiffness_.inverse()
-          * (contactForceMeas
-             + worldContactKine.orientation.toMatrix3().transpose() * linDamping_ * worldContactKine.linVel())
+      worldContactOri
+          * (model.linCompliance_
+             * (contactForceMeas + worldContactOri.transpose() * (model.linDamping_ * worldContactKine.linVel())))
       + worldContactKine.position();
 
   /* We get the reference orientation of the contact by removing the contribution of the visco-elastic model */
   // difference between the reference orientation and the real one, obtained from the visco-elastic model
   so::Vector3 flexRotDiff =
-      -2 * worldContactKine.orientation.toMatrix3() * angStiffness_.inverse()
-      * (contactTorqueMeas
-         + worldContactKine.orientation.toMatrix3().transpose() * angDamping_ * worldContactKine.angVel());
+      -2 * worldContactOri
+      * (model.angCompliance_
+         * (contactTorqueMeas + worldContactOri.transpose() * (model.angDamping_ * worldContactKine.angVel())));
 
   // axis of the rotation
   so::Vector3 flexRotAxis = flexRotDiff / flexRotDiff.norm();
@@ -871,18 +1440,53 @@ void MCKineticsObserver::getOdometryWorldContactRest(const mc_control::MCControl
   Eigen::AngleAxisd flexRotAngleAxis(flexRotAngle, flexRotAxis);
   // matrix representation of the rotation due to the visco-elastic model
   so::Matrix3 flexRotMatrix = so::kine::Orientation(flexRotAngleAxis).toMatrix3();
-  worldContactKineRef.orientation = so::Matrix3(flexRotMatrix.transpose() * worldContactKine.orientation.toMatrix3());
+  worldContactKineRef.orientation = so::Matrix3(flexRotMatrix.transpose() * worldContactOri);
+
+  if(odometryContactRestSetter_ != nullptr) { (this->*odometryContactRestSetter_)(ctl, contact, worldContactKineRef); }
+}
+
+void MCKineticsObserver::setFlatOdometryContactRest(const mc_control::MCController & ctl,
+                                                    KoContactWithSensor & contact,
+                                                    so::kine::Kinematics & worldContactKineRef)
+{
+  // the position odometry is made only along the x and y axis, the position along z is assumed to be the one of the
+  // terrain if its heightmap is given, otherwise the one of the control robot
+  if(heightmap_.loaded())
+  {
+    const so::Vector3 & worldContactPosRef = worldContactKineRef.position();
+    worldContactKineRef.position()(2) = heightmap_.height(worldContactPosRef.x(), worldContactPosRef.y());
+    return;
+  }
+
+  const auto & robot = ctl.robot(robot_);
+  // kinematics of the contact of the control robot in the world frame
+  so::kine::Kinematics worldContactKineControl =
+      getContactWorldKinematics(contact, robot, robot.forceSensor(contact.forceSensorName()));
 
-  if(odometryType_ == measurements::flatOdometry) // if true, the position odometry is made only along the x and y axis,
-                                                  // the position along z is assumed to be the one of the control robot
+  // the reference altitude of the contact is the one in the control robot
+  worldContactKineRef.position()(2) = worldContactKineControl.position()(2);
+}
+
+void MCKineticsObserver::setOdometryType(const measurements::OdometryType & odometryType)
+{
+  odometryType_ = odometryType;
+  if(odometryType_ == measurements::flatOdometry)
   {
-    // kinematics of the contact of the control robot in the world frame
-    so::kine::Kinematics worldContactKineControl =
-        getContactWorldKinematics(contact, robot, robot.forceSensor(contact.forceSensorName()));
+    odometryContactRestSetter_ = &MCKineticsObserver::setFlatOdometryContactRest;
+  }
+  else { odometryContactRestSetter_ = nullptr; }
+}
 
-    // the reference altitude of the contact is the one in the control robot
-    worldContactKineRef.position()(2) = worldContactKineControl.position()(2);
+void MCKineticsObserver::setContactViscoElasticModel(KoContactWithSensor & contact)
+{
+  auto model = contactsViscoElasticModels_.find(contact.surfaceName());
+  if(model == contactsViscoElasticModels_.end())
+  {
+    model = contactsViscoElasticModels_.find(contact.forceSensorName());
   }
+
+  if(model != contactsViscoElasticModels_.end()) { contact.viscoElasticModel_ = model->second; }
+  else { contact.viscoElasticModel_ = defaultViscoElasticModel_; }
 }
 
 void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
@@ -901,7 +1505,7 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
   const auto & robot = ctl.robot(robot_);
   KoContactWithSensor & contact = contactsManager_.contactWithSensor(contactIndex);
 
-  sva::ForceVecd measuredWrench = robot.forceSensor(contact.forceSensorName()).wrenchWithoutGravity(inputRobot);
+  const sva::ForceVecd & measuredWrench = inputForceSensors_(contact.forceSensorName()).wrenchWithoutGravity_;
   const mc_rbdyn::ForceSensor & forceSensor = robot.forceSensor(contact.forceSensorName());
 
   // As used on input robot, returns the kinematics of the contact in the frame of the floating base. Also expresses the
@@ -940,6 +1544,9 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
       // reference of the contact in the world / floating base of the input robot
       so::kine::Kinematics worldContactKineRef;
 
+      // the model of a prepared contact was already selected
+      if(!contact.prewarmed_) { setContactViscoElasticModel(contact); }
+
       if(odometryType_ != measurements::None) // the Kinetics Observer performs odometry. The estimated state is used to
                                               // provide the new contacts references.
       {
@@ -954,12 +1561,16 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
                                                  // whether another contact is already set or not
       {
         observer_.addContact(worldContactKineRef, contactInitCovarianceNewContacts_, contactProcessCovariance_,
-                             contactIndex, linStiffness_, linDamping_, angStiffness_, angDamping_);
+                             contactIndex, contact.viscoElasticModel_.linStiffness_,
+                             contact.viscoElasticModel_.linDamping_, contact.viscoElasticModel_.angStiffness_,
+                             contact.viscoElasticModel_.angDamping_);
       }
       else
       {
         observer_.addContact(worldContactKineRef, contactInitCovarianceFirstContacts_, contactProcessCovariance_,
-                             contactIndex, linStiffness_, linDamping_, angStiffness_, angDamping_);
+                             contactIndex, contact.viscoElasticModel_.linStiffness_,
+                             contact.viscoElasticModel_.linDamping_, contact.viscoElasticModel_.angStiffness_,
+                             contact.viscoElasticModel_.angDamping_);
       }
       if(contact.sensorEnabled_) // checks if the sensor is used in the correction of the Kinetics Observer
                                  // or not
@@ -975,7 +1586,10 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
         observer_.updateContactWithNoSensor(contact.fbContactKine_, contactIndex);
       }
 
-      if(withDebugLogs_) { addContactLogEntries(logger, contactIndex); }
+      // the log entries of a prepared contact are already registered
+      if(withDebugLogs_ && !contact.prewarmed_) { addContactLogEntries(logger, contactIndex); }
+      contact.prewarmed_ = false;
+      if(prewarmedContact_ == contactIndex) { prewarmedContact_ = -1; }
       break;
   }
 }
@@ -1003,6 +1617,51 @@ void MCKineticsObserver::updateContacts(
   if(debug_) { mc_rtc::log::info("nbContacts = {}", nbContacts); }
 }
 
+void MCKineticsObserver::prewarmPlannedContact(const mc_control::MCController & ctl, mc_rtc::Logger & logger)
+{
+  const auto & datastore = ctl.datastore();
+  // the plan was withdrawn
+  if(!datastore.has(plannedContactEntry_) || !datastore.has(timeToLandingEntry_))
+  {
+    releasePrewarmedContact(logger);
+    return;
+  }
+  if(datastore.get<double>(timeToLandingEntry_) > prewarmingHorizon_) { return; }
+
+  const std::string & plannedContact = datastore.get<std::string>(plannedContactEntry_);
+  auto & mapContacts = contactsManager_.mapContacts_;
+  // contacts without sensor are not handled by the Kinetics Observer
+  if(!mapContacts.hasElement(plannedContact) || !mapContacts.hasSensor(plannedContact))
+  {
+    releasePrewarmedContact(logger);
+    return;
+  }
+  const int contactIndex = mapContacts.getNumFromName(plannedContact);
+  if(contactIndex == prewarmedContact_) { return; }
+
+  // the previously planned contact didn't land
+  releasePrewarmedContact(logger);
+
+  KoContactWithSensor & contact = contactsManager_.contactWithSensor(contactIndex);
+  if(contact.isSet_) { return; }
+
+  const auto & robot = ctl.robot(robot_);
+  worldSensorKinematics(contact, robot, robot.forceSensor(contact.forceSensorName()));
+  setContactViscoElasticModel(contact);
+  contact.prewarmed_ = true;
+  if(withDebugLogs_) { addContactLogEntries(logger, contactIndex); }
+  prewarmedContact_ = contactIndex;
+}
+
+void MCKineticsObserver::releasePrewarmedContact(mc_rtc::Logger & logger)
+{
+  if(prewarmedContact_ < 0) { return; }
+  KoContactWithSensor & contact = contactsManager_.contactWithSensor(prewarmedContact_);
+  if(withDebugLogs_) { removeContactLogEntries(logger, prewarmedContact_); }
+  contact.prewarmed_ = false;
+  prewarmedContact_ = -1;
+}
+
 void MCKineticsObserver::mass(double mass)
 {
   mass_ = mass;
@@ -1017,6 +1676,15 @@ void MCKineticsObserver::addToLogger(const mc_control::MCController & ctl,
                                      mc_rtc::Logger & logger,
                                      const std::string & category)
 {
+  perfCounters_.addToLogger(logger, category);
+  golden_.addToLogger(logger, category);
+  standstill_.addToLogger(logger, category);
+  memoryReport_.addToLogger(logger, category);
+  if(async_)
+  {
+    logger.addLogEntry(category + "_async_mergedImuSamples", [this]() { return asyncMergedImuSamples_; });
+  }
+
   logger.addLogEntry(category + "_mcko_fb_posW", [this]() -> sva::PTransformd & { return X_0_fb_; });
   logger.addLogEntry(category + "_mcko_fb_velW", [this]() -> sva::MotionVecd & { return v_fb_0_; });
   logger.addLogEntry(category + "_mcko_fb_accW", [this]() -> sva::MotionVecd & { return a_fb_0_; });
@@ -1027,6 +1695,15 @@ void MCKineticsObserver::addToLogger(const mc_control::MCController & ctl,
   logger.addLogEntry(category + "_constants_mass", [this]() -> double { return observer_.getMass(); });
 
   logger.addLogEntry(category + "_constants_forceThreshold", [this]() -> double { return contactDetectionThreshold_; });
+  // the count of suppressed messages is shared by all the observers, it is logged once
+  logTools::addToLogger(logger);
+  if(withFlightRecorder_)
+  {
+    logger.addLogEntry(category + "_flightRecorder_dumps",
+                       [this]() -> double { return static_cast<double>(flightRecorder_.dumpsCount()); });
+    logger.addLogEntry(category + "_flightRecorder_droppedRecords",
+                       [this]() -> double { return static_cast<double>(flightRecorder_.droppedRecords()); });
+  }
   logger.addLogEntry(category + "_debug_estimationState",
                      [this]() -> std::string
                      {
@@ -1062,6 +1739,10 @@ void MCKineticsObserver::addToLogger(const mc_control::MCController & ctl,
                        return "default";
                      });
 
+  // in the asynchronous mode, the Kinetics Observer may be updated by the worker thread while the logger runs, only
+  // the estimation given to the control thread is logged
+  if(async_) { return; }
+
   /* Plots of the updated state */
   kinematicsTools::addToLogger(globalCentroidKinematics_, logger, observerName_ + "_globalWorldCentroidState");
   logger.addLogEntry(observerName_ + "_globalWorldCentroidState_positionW_",
@@ -1427,13 +2108,19 @@ void MCKineticsObserver::removeFromLogger(mc_rtc::Logger & logger, const std::st
   logger.removeLogEntry(category + "_mass");
   logger.removeLogEntry(category + "_flexStiffness");
   logger.removeLogEntry(category + "_flexDamping");
+  perfCounters_.removeFromLogger(logger, category);
+  golden_.removeFromLogger(logger, category);
+  standstill_.removeFromLogger(logger, category);
+  memoryReport_.removeFromLogger(logger, category);
+  logTools::removeFromLogger(logger);
+  logger.removeLogEntry(category + "_async_mergedImuSamples");
 }
 
 void MCKineticsObserver::changeOdometryType(const mc_control::MCController & ctl, const std::string & newOdometryType)
 {
   OdometryType prevOdometryType = odometryType_;
-  if(newOdometryType == "flatOdometry") { odometryType_ = measurements::flatOdometry; }
-  else if(newOdometryType == "6dOdometry") { odometryType_ = measurements::odometry6d; }
+  if(newOdometryType == "flatOdometry") { setOdometryType(measurements::flatOdometry); }
+  else if(newOdometryType == "6dOdometry") { setOdometryType(measurements::odometry6d); }
 
   // if the type didn't change, we stop the function here
   if(odometryType_ == prevOdometryType) { return; }
@@ -1477,12 +2164,22 @@ void MCKineticsObserver::addToGUI(const mc_control::MCController & ctl,
                                                                   }));
   }
   // clang-format on
+
+  // the worker thread must not update the Kinetics Observer while its memory is estimated, the refresh is otherwise
+  // deferred to the next iteration at which it is idle
+  memoryReport_.addToGUI(gui, category,
+                         [this]()
+                         {
+                           if(asyncUpdate_.running()) { memoryRefreshPending_ = true; }
+                           else { memoryReport_.refresh(); }
+                         });
 }
 
 void MCKineticsObserver::addContactLogEntries(mc_rtc::Logger & logger, const int & contactIndex)
 {
   const std::string & contactName = contactsManager_.mapContacts_.getNameFromNum(contactIndex);
-  if(observer_.getContactIsSetByNum(contactIndex))
+  // the entries are also added before the touchdown of a planned contact, the inputs of the contact are then not read
+  if(observer_.getContactIsSetByNum(contactIndex) || contactsManager_.contactWithSensor(contactIndex).prewarmed_)
   {
     logger.addLogEntry(observerName_ + "_globalWorldCentroidState_contact_" + contactName + "_position",
                        [this, contactIndex]() -> Eigen::Vector3d {
@@ -1592,36 +2289,59 @@ void MCKineticsObserver::addContactLogEntries(mc_rtc::Logger & logger, const int
 
     logger.addLogEntry(observerName_ + "_debug_contactWrench_Centroid_" + contactName + "_force",
                        [this, contactIndex]() -> Eigen::Vector3d
-                       { return observer_.getCentroidContactWrench(contactIndex).segment(0, observer_.sizeForce); });
+                       {
+                         if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Vector3d::Zero(); }
+                         return observer_.getCentroidContactWrench(contactIndex).segment(0, observer_.sizeForce);
+                       });
 
     logger.addLogEntry(observerName_ + "_debug_contactWrench_Centroid_" + contactName + "_torque",
                        [this, contactIndex]() -> Eigen::Vector3d
-                       { return observer_.getCentroidContactWrench(contactIndex).segment(3, observer_.sizeTorque); });
+                       {
+                         if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Vector3d::Zero(); }
+                         return observer_.getCentroidContactWrench(contactIndex).segment(3, observer_.sizeTorque);
+                       });
 
     logger.addLogEntry(observerName_ + "_debug_contactPose_" + contactName + "_inputCentroidContactKine_position",
                        [this, contactIndex]() -> Eigen::Vector3d
-                       { return observer_.getCentroidContactInputPose(contactIndex).position(); });
+                       {
+                         if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Vector3d::Zero(); }
+                         return observer_.getCentroidContactInputPose(contactIndex).position();
+                       });
 
     logger.addLogEntry(
         observerName_ + "_debug_contactPose_" + contactName + "_inputCentroidContactKine_orientation",
         [this, contactIndex]() -> Eigen::Quaternion<double>
-        { return observer_.getCentroidContactInputPose(contactIndex).orientation.inverse().toQuaternion(); });
+        {
+          if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Quaterniond::Identity(); }
+          return observer_.getCentroidContactInputPose(contactIndex).orientation.inverse().toQuaternion();
+        });
 
     logger.addLogEntry(observerName_ + "_debug_contactPose_" + contactName + "_worldContactPoseFromCentroid_position",
                        [this, contactIndex]() -> Eigen::Vector3d
-                       { return observer_.getWorldContactPoseFromCentroid(contactIndex).position(); });
+                       {
+                         if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Vector3d::Zero(); }
+                         return observer_.getWorldContactPoseFromCentroid(contactIndex).position();
+                       });
 
     logger.addLogEntry(
         observerName_ + "_debug_contactPose_" + contactName + "_worldContactPoseFromCentroid_orientation",
         [this, contactIndex]() -> Eigen::Quaternion<double>
-        { return observer_.getWorldContactPoseFromCentroid(contactIndex).orientation.inverse().toQuaternion(); });
+        {
+          if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Quaterniond::Identity(); }
+          return observer_.getWorldContactPoseFromCentroid(contactIndex).orientation.inverse().toQuaternion();
+        });
 
     logger.addLogEntry(observerName_ + "_debug_contactPose_" + contactName + "_inputUserContactKine_position",
                        [this, contactIndex]() -> Eigen::Vector3d
-                       { return observer_.getUserContactInputPose(contactIndex).position(); });
+                       {
+                         if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Vector3d::Zero(); }
+                         return observer_.getUserContactInputPose(contactIndex).position();
+                       });
 
     logger.addLogEntry(observerName_ + "_debug_contactPose_" + contactName + "_inputUserContactKine_orientation",
-                       [this, contactIndex]() -> Eigen::Quaternion<double> {
+                       [this, contactIndex]() -> Eigen::Quaternion<double>
+                       {
+                         if(!observer_.getContactIsSetByNum(contactIndex)) { return Eigen::Quaterniond::Identity(); }
                          return observer_.getUserContactInputPose(contactIndex).orientation.inverse().toQuaternion();
                        });
     logger.addLogEntry(observerName_ + "_debug_contactState_isSet_" + contactName,
@@ -7,6 +7,7 @@
 #include "mc_state_observation/observersTools/leggedOdometryTools.h"
 #include <mc_state_observation/NaiveOdometry.h>
 #include <mc_state_observation/gui_helpers.h>
+#include <mc_state_observation/observersTools/traceTools.h>
 
 #include <RBDyn/CoM.h>
 #include <RBDyn/FA.h>
@@ -26,6 +27,10 @@ NaiveOdometry::NaiveOdometry(const std::string & type, double dt) : mc_observers
 void NaiveOdometry::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
 {
   robot_ = config("robot", ctl.robot().name());
+
+  if(config.has("perfCounters")) { perfCounters_.configure(config("perfCounters"), name()); }
+  if(config.has("golden")) { golden_.configure(config("golden"), name()); }
+
   std::string typeOfOdometry = static_cast<std::string>(config("odometryType"));
   measurements::OdometryType odometryType;
 
@@ -41,9 +46,11 @@ void NaiveOdometry::configure(const mc_control::MCController & ctl, const mc_rtc
 
   bool velUpdatedUpstream = config("velUpdatedUpstream");
   accUpdatedUpstream_ = config("accUpdatedUpstream");
+  config("headless", headless_);
 
   odometryManager_.init(ctl, robot_, "NaiveOdometry", odometryType, true, velUpdatedUpstream, accUpdatedUpstream_,
-                        verbose, true);
+                        verbose, !headless_, headless_);
+  if(config.has("heightmap")) { odometryManager_.heightmap().configure(config("heightmap"), name()); }
 
   /* Configuration of the contacts detection */
 
@@ -106,6 +113,12 @@ void NaiveOdometry::configure(const mc_control::MCController & ctl, const mc_rtc
     odometryManager_.initDetection(ctl, robot_, contactsDetectionMethod, contactsSensorDisabledInit,
                                    contactDetectionThreshold_, forceSensorsToOmit);
   }
+
+  /* Memory accounting */
+
+  memoryReport_.add("robots", [this]() { return memoryTools::bytes(my_robots_); });
+  memoryReport_.add("odometryRobots", [this]() { return memoryTools::bytes(odometryManager_.odometryRobots()); });
+  memoryReport_.add("heightmap", [this]() { return odometryManager_.heightmap().bufferSize(); });
 }
 
 void NaiveOdometry::reset(const mc_control::MCController & ctl)
@@ -142,16 +155,26 @@ void NaiveOdometry::reset(const mc_control::MCController & ctl)
 
   my_robots_ = mc_rbdyn::Robots::make();
   my_robots_->robotCopy(robot, robot.name());
-  ctl.gui()->addElement(
-      {"Robots"},
-      mc_rtc::gui::Robot("NaiveOdometry", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  if(!headless_)
+  {
+    ctl.gui()->addElement(
+        {"Robots"},
+        mc_rtc::gui::Robot("NaiveOdometry", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  }
 
   X_0_fb_.translation() = realRobot.posW().translation();
   X_0_fb_.rotation() = realRobot.posW().rotation();
+
+  odometryManager_.heightmap().resolve(ctl);
+
+  memoryReport_.refresh();
 }
 
 bool NaiveOdometry::run(const mc_control::MCController & ctl)
 {
+  MCSO_TRACE_SCOPE("NaiveOdometry::run");
+  perfCounters::Scope perfScope(perfCounters_);
+  golden_.start();
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
 
   //  if the acceleration was estimated by a previous estimator, it can be updated
@@ -162,6 +185,8 @@ bool NaiveOdometry::run(const mc_control::MCController & ctl)
   my_robots_->robot().mbc().q = ctl.realRobot().mbc().q;
   update(my_robots_->robot());
 
+  golden_.stop(X_0_fb_, v_fb_0_);
+
   return true;
 }
 
@@ -169,9 +194,29 @@ bool NaiveOdometry::run(const mc_control::MCController & ctl)
 /// -------------------------Called functions--------------------------
 ///////////////////////////////////////////////////////////////////////
 
+void NaiveOdometry::runBatch(mc_control::MCController & ctl,
+                            const batchTools::InputView & inputs,
+                            batchTools::OutputView outputs)
+{
+  if(!headless_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The batch processing requires a headless observer", name());
+  }
+
+  // the run function is called without virtual dispatch, the estimation is read directly from the members
+  batchTools::runBatch(ctl, robot_, inputs, outputs, name(),
+                       [this, &ctl](sva::PTransformd & X, sva::MotionVecd & v)
+                       {
+                         NaiveOdometry::run(ctl);
+                         X = X_0_fb_;
+                         v = v_fb_0_;
+                       });
+}
+
 void NaiveOdometry::update(mc_control::MCController & ctl) // this function is called by the pipeline if the
                                                            // update is set to true in the configuration file
 {
+  MCSO_TRACE_SCOPE("NaiveOdometry::update");
   auto & realRobot = ctl.realRobot(robot_);
   update(realRobot);
 }
@@ -202,6 +247,12 @@ void NaiveOdometry::addToLogger(const mc_control::MCController &, mc_rtc::Logger
                      [this]() -> double { return -so::kine::rotationMatrixToYawAxisAgnostic(X_0_fb_.rotation()); });
 
   logger.addLogEntry(category + "_constants_forceThreshold", [this]() -> double { return contactDetectionThreshold_; });
+  // the count of suppressed messages is shared by all the observers, it is logged once
+  logTools::addToLogger(logger);
+
+  perfCounters_.addToLogger(logger, category);
+  golden_.addToLogger(logger, category);
+  memoryReport_.addToLogger(logger, category);
 }
 
 void NaiveOdometry::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -211,19 +262,17 @@ void NaiveOdometry::removeFromLogger(mc_rtc::Logger & logger, const std::string
   logger.removeLogEntry(category + "_mass");
   logger.removeLogEntry(category + "_flexStiffness");
   logger.removeLogEntry(category + "_flexDamping");
+  perfCounters_.removeFromLogger(logger, category);
+  golden_.removeFromLogger(logger, category);
+  memoryReport_.removeFromLogger(logger, category);
+  logTools::removeFromLogger(logger);
 }
 
 void NaiveOdometry::addToGUI(const mc_control::MCController &,
                              mc_rtc::gui::StateBuilder & gui,
                              const std::vector<std::string> & category)
 {
-  using namespace mc_rtc::gui;
-  // unused variables
-  (void)gui;
-  (void)category;
-  // clang-format off
-
-  // clang-format on
+  memoryReport_.addToGUI(gui, category, [this]() { memoryReport_.refresh(); });
 }
 
 } // namespace mc_state_observation
@@ -7,6 +7,7 @@
 #include <Eigen/src/Geometry/Transform.h>
 #include <mc_state_observation/ObjectObserver.h>
 #include <mc_state_observation/gui_helpers.h>
+#include <mc_state_observation/observersTools/traceTools.h>
 
 namespace mc_state_observation
 {
@@ -41,7 +42,13 @@ void ObjectObserver::configure(const mc_control::MCController & controller, cons
   }
   else { mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Object configuration is mandatory.", name()); }
 
-  if(config.has("Publish")) { isPublished_ = config("Publish")("use", true); }
+  if(config.has("Publish"))
+  {
+    isPublished_ = config("Publish")("use", true);
+    config("Publish")("robotRate", robotPublishRate_);
+  }
+
+  if(config.has("Thread")) { spinnerThread_.load(config("Thread")); }
 
   ctl.datastore().make_call(object_ + "::Robot",
                             [this, &ctl]() -> const mc_rbdyn::Robot & { return ctl.realRobot(object_); });
@@ -88,10 +95,15 @@ void ObjectObserver::configure(const mc_control::MCController & controller, cons
 
   desc_ = fmt::format("{} (Object: {}, Topic: {}, inRobotMap: {})", name(), object_, topic_, isInRobotMap_);
 
-  thread_ = std::thread(std::bind(&ObjectObserver::rosSpinner, this));
+  thread_ = threadTools::startThread(spinnerThread_, name(), [this]() { rosSpinner(); });
+
+  memoryReport_.add("robots", [this]() { return memoryTools::bytes(robots_); });
 }
 
-void ObjectObserver::reset(const mc_control::MCController &) {}
+void ObjectObserver::reset(const mc_control::MCController &)
+{
+  memoryReport_.refresh();
+}
 
 bool ObjectObserver::run(const mc_control::MCController &)
 {
@@ -100,6 +112,7 @@ bool ObjectObserver::run(const mc_control::MCController &)
 
 void ObjectObserver::update(mc_control::MCController & ctl)
 {
+  MCSO_TRACE_SCOPE("ObjectObserver::update");
   {
     const std::lock_guard<std::mutex> lock(mutex_);
     ctl.datastore().assign<bool>("Object::" + object_ + "::IsValid", isEstimatedPoseValid_);
@@ -145,10 +158,18 @@ void ObjectObserver::update(mc_control::MCController & ctl)
 
   if(isPublished_)
   {
-    mc_rtc::ROSBridge::update_robot_publisher(object_ + "_estimated", ctl.timeStep, object);
-    if(ctl.datastore().has("SLAM::Robot"))
+    // the robot publisher of mc_rtc sends the messages from its own thread, we only limit the rate at which the state is
+    // copied to it
+    robotPublishElapsed_ += ctl.timeStep;
+    if(robotPublishElapsed_ >= 1.0 / robotPublishRate_)
     {
-      mc_rtc::ROSBridge::update_robot_publisher(object_ + "_estimated_in_SLAM", ctl.timeStep, robots_->robot(object_));
+      mc_rtc::ROSBridge::update_robot_publisher(object_ + "_estimated", robotPublishElapsed_, object);
+      if(ctl.datastore().has("SLAM::Robot"))
+      {
+        mc_rtc::ROSBridge::update_robot_publisher(object_ + "_estimated_in_SLAM", robotPublishElapsed_,
+                                                  robots_->robot(object_));
+      }
+      robotPublishElapsed_ = 0.0;
     }
   }
 }
@@ -174,6 +195,7 @@ void ObjectObserver::addToLogger(const mc_control::MCController & ctl,
                        sva::PTransformd X_0_object = ctl.robot(object_).posW();
                        return X_0_object * X_0_camera.inv();
                      });
+  memoryReport_.addToLogger(logger, category);
 }
 
 void ObjectObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -183,6 +205,7 @@ void ObjectObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string
   logger.removeLogEntry(category + "_X_Camera_Object_Estimated");
   logger.removeLogEntry(category + "_X_Camera_Object_Real");
   logger.removeLogEntry(category + "_X_Camera_Object_Control");
+  memoryReport_.removeFromLogger(logger, category);
 }
 
 void ObjectObserver::addToGUI(const mc_control::MCController & ctl,
@@ -197,6 +220,7 @@ void ObjectObserver::addToGUI(const mc_control::MCController & ctl,
                                           const std::lock_guard<std::mutex> lock(mutex_);
                                           return X_Camera_EstimatedObject_;
                                         }));
+  memoryReport_.addToGUI(gui, category, [this]() { memoryReport_.refresh(); });
 }
 
 void ObjectObserver::callback(const PoseStamped & msg)
@@ -223,7 +247,10 @@ void ObjectObserver::rosSpinner()
   RosRate rate(200);
   while(ros_ok())
   {
-    spinOnce(nh_);
+    {
+      MCSO_TRACE_SCOPE("ObjectObserver::spinOnce");
+      spinOnce(nh_);
+    }
     rate.sleep();
   }
   mc_rtc::log::info("[{}] rosSpinner finished", name());
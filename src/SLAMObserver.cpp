@@ -1,5 +1,6 @@
 #include <mc_state_observation/SLAMObserver.h>
 #include <mc_state_observation/gui_helpers.h>
+#include <mc_state_observation/observersTools/traceTools.h>
 
 #include <mc_observers/ObserverMacros.h>
 
@@ -11,45 +12,6 @@
 #include <SpaceVecAlg/Conversions.h>
 #include <SpaceVecAlg/SpaceVecAlg>
 
-#include <random>
-
-namespace
-{
-
-template<typename Derived>
-Derived generate(const Derived & lower, const Derived & upper)
-{
-  assert(lower.size() == upper.size());
-
-  std::random_device rd; // Will be used to obtain a seed for the random number engine
-  std::mt19937 gen(rd()); // Standard mersenne_twister_engine seeded with rd()
-
-  Derived noise = Derived::Zero();
-  for(int i = 0; i < lower.size(); i++)
-  {
-    std::uniform_real_distribution<> dis(lower[i], upper[i]);
-    noise(i) = dis(gen);
-  }
-  return noise;
-}
-
-sva::PTransformd apply(const sva::PTransformd & X,
-                       const Eigen::Vector3d & min_ori,
-                       const Eigen::Vector3d & max_ori,
-                       const Eigen::Vector3d & min_t,
-                       const Eigen::Vector3d & max_t)
-{
-  const Eigen::Vector3d & noise_t = generate(min_t, max_t);
-  const Eigen::Vector3d & noise_ori = generate(min_ori, max_ori);
-  const Eigen::Matrix3d & noise_R = mc_rbdyn::rpyToMat(noise_ori.x(), noise_ori.y(), noise_ori.z());
-
-  Eigen::Vector3d t_noisy = X.translation() + noise_t;
-  Eigen::Matrix3d R_noisy = (X.rotation() * noise_R).eval();
-  return sva::PTransformd(R_noisy, t_noisy);
-}
-
-} // namespace
-
 namespace mc_state_observation
 {
 
@@ -100,7 +62,13 @@ void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
   auto sg_conf = gram_sg::SavitzkyGolayFilterConfig(m, m, n, d);
   filter_.reset(new filter::Transform(sg_conf));
 
-  if(config.has("Publish")) { isPublished_ = config("Publish")("use", true); }
+  if(config.has("Publish"))
+  {
+    isPublished_ = config("Publish")("use", true);
+    config("Publish")("robotRate", robotPublishRate_);
+    config("Publish")("tfRate", tfPublishRate_);
+    if(config("Publish").has("thread")) { publisherThread_.load(config("Publish")("thread")); }
+  }
 
   if(config.has("Simulation"))
   {
@@ -117,13 +85,19 @@ void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
       if(noise.has("orientation"))
       {
         minOrientationNoise_ = noise("orientation")("min", Eigen::Vector3d(-1, -1, -1));
-        minOrientationNoise_.unaryExpr(&mc_rtc::constants::toRad);
+        minOrientationNoise_ = minOrientationNoise_.unaryExpr(&mc_rtc::constants::toRad);
         maxOrientationNoise_ = noise("orientation")("max", Eigen::Vector3d(1, 1, 1));
-        maxOrientationNoise_.unaryExpr(&mc_rtc::constants::toRad);
+        maxOrientationNoise_ = maxOrientationNoise_.unaryExpr(&mc_rtc::constants::toRad);
       }
     }
+    lowerPoseNoise_ << minOrientationNoise_, minTranslationNoise_;
+    upperPoseNoise_ << maxOrientationNoise_, maxTranslationNoise_;
     if(isSimulated_)
     {
+      // the seed, delay and dropout probability allow reproducible stress tests of the estimators using the SLAM
+      noiseEngine_.configure(config("Simulation"), name());
+      simulationDelay_.init(config("Simulation")("delay", 0.0), ctl.timeStep);
+      simulationDropout_ = config("Simulation")("dropout", 0.0);
       estimated_ = "real/" + camera_;
       mc_rtc::log::info("[{}] Simulation mode is active so SLAM estimated link is set to {}", name(), estimated_);
     }
@@ -131,15 +105,37 @@ void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
 
   if(config.has("GUI")) { config("GUI")("plots", plotsEnabled_); }
 
+  if(config.has("Thread")) { spinnerThread_.load(config("Thread")); }
+
   desc_ = fmt::format("{} (Camera: {}, Estimated: {}, inSimulation: {})", name(), camera_, estimated_, isSimulated_);
 
-  thread_ = std::thread(std::bind(&SLAMObserver::rosSpinner, this));
+  thread_ = threadTools::startThread(spinnerThread_, name(), [this]() { rosSpinner(); });
+
+  mapFrame_ = tfPublisher_.addFrame("robot_map", map_, tfPublishRate_);
+  tfPublisher_.start(publisherThread_, name());
+
+  /* Memory accounting */
+
+  memoryReport_.add("robots", [this]() { return memoryTools::bytes(robots_); });
+  memoryReport_.add("filter",
+                    [this]()
+                    {
+                      // windows of the translation and rotation filters and their weights
+                      const auto window = static_cast<size_t>(2 * filter_->config().m + 1);
+                      return sizeof(filter::Transform)
+                             + window * (sizeof(Eigen::Vector3d) + sizeof(Eigen::Matrix3d) + 2 * sizeof(double));
+                    });
+  memoryReport_.add("simulationDelay", [this]() { return simulationDelay_.bufferSize(); });
 }
 
-void SLAMObserver::reset(const mc_control::MCController &) {}
+void SLAMObserver::reset(const mc_control::MCController &)
+{
+  memoryReport_.refresh();
+}
 
 bool SLAMObserver::run(const mc_control::MCController & ctl)
 {
+  MCSO_TRACE_SCOPE("SLAMObserver::run");
   isSLAMAlive_ = false;
 
   t_ += ctl.solver().dt();
@@ -175,12 +171,8 @@ bool SLAMObserver::run(const mc_control::MCController & ctl)
   }
   else
   {
-    // Connect SLAM and Robot map
-    auto transform = tf2::eigenToTransform(sva::conversions::toAffine(X_0_Slam_));
-    transform.header.stamp = RosTimeNow();
-    transform.header.frame_id = "robot_map";
-    transform.child_frame_id = map_;
-    tfBroadcaster_.sendTransform(transform);
+    // Connect SLAM and Robot map, the transform is sent by the publisher thread
+    tfPublisher_.set(mapFrame_, X_0_Slam_);
 
     if(isSimulated_)
     {
@@ -189,11 +181,21 @@ bool SLAMObserver::run(const mc_control::MCController & ctl)
       const sva::PTransformd X_0_FF = real_robot.bodyPosW(body_);
       const sva::PTransformd X_0_Camera = real_robot.bodyPosW(camera_);
       const sva::PTransformd X_Camera_Freeflyer = X_0_FF * X_0_Camera.inv();
-      X_0_Estimated_camera_ = X_Camera_Freeflyer.inv() * X_0_FFsensor;
+      sva::PTransformd X_0_Measured_camera = X_Camera_Freeflyer.inv() * X_0_FFsensor;
       if(isUsingNoise_)
       {
-        X_0_Estimated_camera_ = apply(X_0_Estimated_camera_, minOrientationNoise_, maxOrientationNoise_,
-                                      minTranslationNoise_, maxTranslationNoise_);
+        X_0_Measured_camera = noiseEngine_.applyPoseNoise(X_0_Measured_camera, lowerPoseNoise_, upperPoseNoise_);
+      }
+      // the SLAM didn't provide any estimate yet (delay) or lost the tracking (dropout)
+      if(!simulationDelay_.push(t_, X_0_Measured_camera, X_0_Estimated_camera_))
+      {
+        error_ = fmt::format("[{}] Waiting for the simulated SLAM delay ({} s)", name(), simulationDelay_.delay());
+        return false;
+      }
+      if(noiseEngine_.drop(simulationDropout_))
+      {
+        error_ = fmt::format("[{}] Simulated SLAM dropout", name());
+        return false;
       }
     }
     else
@@ -216,6 +218,7 @@ bool SLAMObserver::run(const mc_control::MCController & ctl)
 
 void SLAMObserver::update(mc_control::MCController & ctl)
 {
+  MCSO_TRACE_SCOPE("SLAMObserver::update");
   if(!isInitialized_)
   {
     if(ctl.datastore().has("SLAM::Robot")) { ctl.datastore().remove("SLAM::Robot"); }
@@ -260,7 +263,17 @@ void SLAMObserver::update(mc_control::MCController & ctl)
   SLAM_robot.posW(X_0_Estimated_Freeflyer);
   SLAM_robot.forwardKinematics();
 
-  if(isPublished_) { mc_rtc::ROSBridge::update_robot_publisher("SLAM", ctl.timeStep, SLAM_robot); }
+  if(isPublished_)
+  {
+    // the robot publisher of mc_rtc sends the messages from its own thread, we only limit the rate at which the state is
+    // copied to it
+    robotPublishElapsed_ += ctl.timeStep;
+    if(robotPublishElapsed_ >= 1.0 / robotPublishRate_)
+    {
+      mc_rtc::ROSBridge::update_robot_publisher("SLAM", robotPublishElapsed_, SLAM_robot);
+      robotPublishElapsed_ = 0.0;
+    }
+  }
 }
 
 void SLAMObserver::addToLogger(const mc_control::MCController &, mc_rtc::Logger & logger, const std::string & category)
@@ -290,6 +303,7 @@ void SLAMObserver::addToLogger(const mc_control::MCController &, mc_rtc::Logger
                      { return (robots_->size() == 1 ? robots_->robot().posW() : sva::PTransformd::Identity()); });
   logger.addLogEntry(category + "_camera", [this]() { return X_0_Estimated_camera_; });
   logger.addLogEntry(category + "_cameraFiltered", [this]() { return X_0_Filtered_estimated_camera_; });
+  memoryReport_.addToLogger(logger, category);
 }
 
 void SLAMObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -303,6 +317,7 @@ void SLAMObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string &
   logger.removeLogEntry(category + "_posW");
   logger.removeLogEntry(category + "_camera");
   logger.removeLogEntry(category + "_cameraFiltered");
+  memoryReport_.removeFromLogger(logger, category);
 }
 
 void SLAMObserver::addToGUI(const mc_control::MCController & ctl,
@@ -401,6 +416,8 @@ void SLAMObserver::addToGUI(const mc_control::MCController & ctl,
                        }));
   }
 
+  memoryReport_.addToGUI(gui, category, [this]() { memoryReport_.refresh(); });
+
   if(plotsEnabled_) { addPlots(gui); }
 }
 
@@ -494,7 +511,10 @@ void SLAMObserver::rosSpinner()
   RosRate rate(30);
   while(ros_ok())
   {
-    spinOnce(nh_);
+    {
+      MCSO_TRACE_SCOPE("SLAMObserver::spinOnce");
+      spinOnce(nh_);
+    }
     rate.sleep();
   }
   mc_rtc::log::info("[{}] rosSpinner finished", name());
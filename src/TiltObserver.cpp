@@ -3,6 +3,7 @@
 #include <mc_state_observation/TiltObserver.h>
 #include <mc_state_observation/gui_helpers.h>
 #include <mc_state_observation/observersTools/kinematicsTools.h>
+#include <mc_state_observation/observersTools/traceTools.h>
 
 namespace mc_state_observation
 {
@@ -22,11 +23,16 @@ void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
 {
   robot_ = config("robot", ctl.robot().name());
 
+  if(config.has("perfCounters")) { perfCounters_.configure(config("perfCounters"), name()); }
+  if(config.has("golden")) { golden_.configure(config("golden"), name()); }
+
   imuSensor_ = config("imuSensor", ctl.robot().bodySensor().name());
 
   config("maxAnchorFrameDiscontinuity", maxAnchorFrameDiscontinuity_);
   config("updateRobot", updateRobot_);
+  config("jointsKinematicsUpdatedUpstream", jointsKinematicsUpdatedUpstream_);
   config("updateSensor", updateSensor_);
+  config("headless", headless_);
 
   config("initAlpha", alpha_);
   config("initBeta", beta_);
@@ -65,7 +71,8 @@ void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
     bool withYawEstimation = config("withYawEstimation", true);
 
     odometryManager_.init(ctl, robot_, observerName_, odometryManager_.odometryType_, withYawEstimation,
-                          velUpdatedUpstream, accUpdatedUpstream, verbose);
+                          velUpdatedUpstream, accUpdatedUpstream, verbose, false, headless_);
+    if(config.has("heightmap")) { odometryManager_.heightmap().configure(config("heightmap"), name()); }
 
     // surfaces used for the contact detection. If the desired detection method doesn't use surfaces, we make sure this
     // list is not filled in the configuration file to avoid the use of an undesired method.
@@ -133,6 +140,11 @@ void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
     }
   }
 
+  // the odometry type may change later, but the odometry is either performed or not for the whole lifetime of the
+  // observer
+  const bool withOdometry = odometryManager_.odometryType_ != measurements::None;
+  tiltEstimatorRunner_ = withOdometry ? &TiltObserver::runTiltEstimator<true> : &TiltObserver::runTiltEstimator<false>;
+
   // check if this observer is used as a backup. If yes we add the backup function to the datastore.
   config("asBackup", asBackup_);
   if(asBackup_)
@@ -148,6 +160,13 @@ void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
     datastore.make_call("changeTiltOdometryType",
                         [this](const std::string & newOdometryType) { changeOdometryType(newOdometryType); });
   }
+
+  /* Memory accounting */
+
+  memoryReport_.add("robots", [this]() { return memoryTools::bytes(my_robots_); });
+  memoryReport_.add("odometryRobots", [this]() { return memoryTools::bytes(odometryManager_.odometryRobots()); });
+  memoryReport_.add("backupFbKinematics", [this]() { return memoryTools::bytes(backupFbKinematics_); });
+  memoryReport_.add("heightmap", [this]() { return odometryManager_.heightmap().bufferSize(); });
 }
 
 void TiltObserver::reset(const mc_control::MCController & ctl)
@@ -161,9 +180,12 @@ void TiltObserver::reset(const mc_control::MCController & ctl)
   // the updated robot has the same floating base's pose than the control robot, but its encoders are updated. We use it
   // to get more accurate local Kinematics.
   my_robots_->robotCopy(robot, "updatedRobot");
-  ctl.gui()->addElement(
-      {"Robots"},
-      mc_rtc::gui::Robot("TiltEstimator", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  if(!headless_)
+  {
+    ctl.gui()->addElement(
+        {"Robots"},
+        mc_rtc::gui::Robot("TiltEstimator", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  }
   /*
 ctl.gui()->addElement(
   {"Robots"},
@@ -204,6 +226,8 @@ my_robots_->robot("updatedRobot"); }));
   imuVelC_ = sva::MotionVecd::Zero();
   X_C_IMU_ = sva::PTransformd::Identity();
 
+  if(odometryManager_.odometryType_ != measurements::None) { odometryManager_.heightmap().resolve(ctl); }
+
   // we check if this estimator is used as a backup of the Kinetics Observer
   if(asBackup_)
   {
@@ -211,12 +235,21 @@ my_robots_->robot("updatedRobot"); }));
     int backupIterInterval = ctl.datastore().get<int>("koBackupIterInterval");
 
     backupFbKinematics_.resize(backupIterInterval);
-    ctl.gui()->addElement({"OdometryBackup"}, mc_rtc::gui::Button("OdometryBackup", [this, &ctl]() { backupFb(ctl); }));
+    if(!headless_)
+    {
+      ctl.gui()->addElement({"OdometryBackup"},
+                            mc_rtc::gui::Button("OdometryBackup", [this, &ctl]() { backupFb(ctl); }));
+    }
   }
+
+  memoryReport_.refresh();
 }
 
 bool TiltObserver::run(const mc_control::MCController & ctl)
 {
+  MCSO_TRACE_SCOPE("TiltObserver::run");
+  perfCounters::Scope perfScope(perfCounters_);
+  golden_.start();
   const auto & robot = ctl.robot(robot_);
   const auto & realRobot = ctl.realRobot(robot_);
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
@@ -235,8 +268,7 @@ bool TiltObserver::run(const mc_control::MCController & ctl)
     gamma_ = finalGamma_;
   }
 
-  if(odometryManager_.odometryType_ == measurements::None) { runTiltEstimator(ctl, my_robots_->robot("updatedRobot")); }
-  else { runTiltEstimator(ctl, odometryManager_.odometryRobot()); }
+  (this->*tiltEstimatorRunner_)(ctl);
 
   iter_++;
 
@@ -244,13 +276,16 @@ bool TiltObserver::run(const mc_control::MCController & ctl)
   my_robots_->robot().mbc().q = realRobot.mbc().q;
   update(my_robots_->robot());
 
+  golden_.stop(poseW_, velW_);
+
   return true;
 }
 
+template<bool withOdometry>
 void TiltObserver::updateAnchorFrame(const mc_control::MCController & ctl, const mc_rbdyn::Robot & updatedRobot)
 {
   // update of the pose of the anchor frame of the control and updatedRobot in the world.
-  if(odometryManager_.odometryType_ != measurements::None)
+  if constexpr(withOdometry)
   {
     // we compute the anchor frame using the lastly computed floating base so we use the previous encoders information.
     // we use the current force sensors reading.
@@ -345,8 +380,11 @@ void TiltObserver::updateAnchorFrameNoOdometry(const mc_control::MCController &
   }
 }
 
-void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const mc_rbdyn::Robot & updatedRobot)
+template<bool withOdometry>
+void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl)
 {
+  const mc_rbdyn::Robot & updatedRobot =
+      withOdometry ? odometryManager_.odometryRobot() : my_robots_->robot("updatedRobot");
   /*
   For the kinematics of the IMU and anchor frame in the world frame, we use the control robot.
   For internal kinematics like the anchor frame in the IMU, we use the updated robot whose encoders got updated.
@@ -360,7 +398,7 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
 
   // updates the anchor frame used by the tilt observer.
   // If we perform odometry, the control and real robot anchor frame are both the one of the odometry robot.
-  updateAnchorFrame(ctl, updatedRobot);
+  updateAnchorFrame<withOdometry>(ctl, updatedRobot);
 
   // Anchor frame defined w.r.t control robot
   // XXX what if the feet are being moved by the stabilizer?
@@ -377,14 +415,16 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
 
   // In the case we do odometry, the pose and velocities of the odometry robot are still not updated but the joints are.
   // It is not a problem as this kinematics object is not used to retrieve global poses and velocities.
-  updatedWorldFbKine_ = kinematicsTools::poseAndVelFromSva(updatedRobot.posW(), updatedRobot.velW(), true);
+  const kinematicsTools::PoseVelKinematics updatedWorldFbKine =
+      kinematicsTools::PoseVelKinematics::fromSva(updatedRobot.posW(), updatedRobot.velW(), true);
+  updatedWorldFbKine_ = updatedWorldFbKine.toKinematics();
 
   // we use the imu object of control robot because the copy of BodySensor objects seems to be incomplete. Anyway we use
   // it only to get information about the parent body, which is the same with the control robot.
   const sva::PTransformd & imuXbs = imu.X_b_s();
 
-  so::kine::Kinematics parentImuKine =
-      kinematicsTools::poseFromSva(imuXbs, so::kine::Kinematics::Flags::pose | so::kine::Kinematics::Flags::vel);
+  // the IMU is fixed in its parent body: zero velocities
+  const kinematicsTools::PoseVelKinematics parentImuKine = kinematicsTools::PoseVelKinematics::fromSva(imuXbs);
 
   const sva::PTransformd & parentPoseW = robot.bodyPosW(imu.parentBody());
   const sva::PTransformd & updatedParentPoseW = updatedRobot.bodyPosW(imu.parentBody());
@@ -394,27 +434,29 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
 
   auto & updated_v_0_imuParent = updatedRobot.mbc().bodyVelW[updatedRobot.bodyIndexByName(imu.parentBody())];
 
-  so::kine::Kinematics worldParentKine = kinematicsTools::poseAndVelFromSva(parentPoseW, v_0_imuParent, true);
-  so::kine::Kinematics updatedWorldParentKine =
-      kinematicsTools::poseAndVelFromSva(updatedParentPoseW, updated_v_0_imuParent, true);
+  const kinematicsTools::PoseVelKinematics worldParentKine =
+      kinematicsTools::PoseVelKinematics::fromSva(parentPoseW, v_0_imuParent, true);
+  const kinematicsTools::PoseVelKinematics updatedWorldParentKine =
+      kinematicsTools::PoseVelKinematics::fromSva(updatedParentPoseW, updated_v_0_imuParent, true);
 
   // pose and velocities of the IMU in the world frame
-  worldImuKine_ = worldParentKine * parentImuKine;
-  updatedWorldImuKine_ = updatedWorldParentKine * parentImuKine;
+  const kinematicsTools::PoseVelKinematics updatedWorldImuKine = updatedWorldParentKine * parentImuKine;
+  worldImuKine_ = (worldParentKine * parentImuKine).toKinematics();
+  updatedWorldImuKine_ = updatedWorldImuKine.toKinematics();
 
   // pose and velocities of the IMU in the floating base. Use of updated robot to use encoders.
-  updatedFbImuKine_ = updatedWorldFbKine_.getInverse() * updatedWorldImuKine_;
+  updatedFbImuKine_ = (updatedWorldFbKine.inverse() * updatedWorldImuKine).toKinematics();
 
   // new pose of the anchor frame in the IMU frame. The velocity is computed right after because we don't want to use
   // the one given by mc_rtc.
-  so::kine::Kinematics newUpdatedImuAnchorKine = updatedWorldImuKine_.getInverse() * updatedWorldAnchorKine_;
-
   // The velocities of the IMU in the world (given by mc_rtc) and the ones of the anchor frame in the world (by finite
   // differences) are not computed the same way, combining them to get the velocity of the anchor frame in the IMU frame
-  // therefore leads to errors. So we "unset" the erroneous newly compute velocities to compute them by finite
-  // differences from the pose of the anchor frame in the IMU.
-  newUpdatedImuAnchorKine.linVel.set(false);
-  newUpdatedImuAnchorKine.angVel.set(false);
+  // therefore leads to errors. So only the pose is computed, the velocities are then obtained by finite differences
+  // from the pose of the anchor frame in the IMU.
+  so::kine::Kinematics newUpdatedImuAnchorKine =
+      (kinematicsTools::lazy(updatedWorldImuKine).inverse() * kinematicsTools::lazy(updatedWorldAnchorKine_))
+          .evaluate<kinematicsTools::staticFields::pose>()
+          .toKinematics();
 
   updatedImuAnchorKine_.update(newUpdatedImuAnchorKine, ctl.timeStep, flagPoseVels_);
 
@@ -432,7 +474,7 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
 
   // computation of the local linear velocity of the IMU in the world.
 
-  if(odometryManager_.odometryType_ == measurements::None) // case if we don't use odometry
+  if constexpr(!withOdometry)
   {
     x1_ = worldImuKine_.orientation.toMatrix3().transpose() * worldAnchorKine_.linVel()
           - (imu.angularVelocity()).cross(updatedImuAnchorKine_.position()) - updatedImuAnchorKine_.linVel();
@@ -495,7 +537,7 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
   // Once we obtain the tilt (which is required by the legged odometry, estimating only the yaw), we update the pose and
   // velocities of the floating base
 
-  if(odometryManager_.odometryType_ != measurements::None)
+  if constexpr(withOdometry)
   {
     // we can update the estimated pose using odometry. The velocity will be updated later using the estimated local
     // linear velocity of the IMU.
@@ -504,7 +546,7 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
     odometryManager_.run(ctl, logger, poseW_, R_0_fb_);
   }
 
-  updatePoseAndVel(xk_.head(3), imu.angularVelocity());
+  updatePoseAndVel<withOdometry>(xk_.head(3), imu.angularVelocity());
   backupFbKinematics_.push_back(poseW_);
 
   // update the velocities as MotionVecd for the logs
@@ -516,15 +558,19 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
   X_C_IMU_.rotation() = updatedAnchorImuKine.orientation.toMatrix3().transpose();
 }
 
+template<bool withOdometry>
 void TiltObserver::updatePoseAndVel(const so::Vector3 & localWorldImuLinVel, const so::Vector3 & localWorldImuAngVel)
 {
   // if we use odometry, the pose will already updated in odometryManager_.run(...)
-  if(odometryManager_.odometryType_ == measurements::None)
+  if constexpr(!withOdometry)
   {
-    so::kine::Kinematics updatedFbAnchorKine = updatedWorldFbKine_.getInverse() * updatedWorldAnchorKine_;
+    // only the position of the anchor frame in the floating base is required
+    const kinematicsTools::PoseKinematics updatedFbAnchorKine =
+        (kinematicsTools::lazy(updatedWorldFbKine_).inverse() * kinematicsTools::lazy(updatedWorldAnchorKine_))
+            .evaluate<kinematicsTools::staticFields::pose>();
 
     correctedWorldFbKine_.orientation = R_0_fb_;
-    correctedWorldFbKine_.position = worldAnchorKine_.position() - R_0_fb_ * updatedFbAnchorKine.position();
+    correctedWorldFbKine_.position = worldAnchorKine_.position() - R_0_fb_ * updatedFbAnchorKine.position;
 
     poseW_.translation() = correctedWorldFbKine_.position();
     poseW_.rotation() = R_0_fb_.transpose();
@@ -532,20 +578,28 @@ void TiltObserver::updatePoseAndVel(const so::Vector3 & localWorldImuLinVel, con
   else { correctedWorldFbKine_ = kinematicsTools::poseFromSva(poseW_, so::kine::Kinematics::Flags::pose); }
 
   // we use the newly estimated orientation and local linear velocity of the IMU to obtain the one of the floating base.
-  correctedWorldImuKine_ =
-      correctedWorldFbKine_
-      * updatedFbImuKine_; // corrected pose of the imu in the world. This step is used only to get the
-                           // pose of the IMU in the world that is required for the kinematics composition.
-
-  correctedWorldImuKine_.linVel = correctedWorldImuKine_.orientation * localWorldImuLinVel;
-  correctedWorldImuKine_.angVel = correctedWorldImuKine_.orientation * localWorldImuAngVel;
-
-  correctedWorldFbKine_ = correctedWorldImuKine_ * updatedFbImuKine_.getInverse();
+  // corrected pose of the imu in the world. This step is used only to get the pose of the IMU in the world that is
+  // required for the kinematics composition, the velocities of the composition are not computed.
+  const kinematicsTools::PoseKinematics correctedWorldImuPose =
+      (kinematicsTools::lazy(correctedWorldFbKine_) * kinematicsTools::lazy(updatedFbImuKine_))
+          .evaluate<kinematicsTools::staticFields::pose>();
+
+  kinematicsTools::PoseVelKinematics correctedWorldImuKine;
+  correctedWorldImuKine.position = correctedWorldImuPose.position;
+  correctedWorldImuKine.orientation = correctedWorldImuPose.orientation;
+  correctedWorldImuKine.linVel = correctedWorldImuPose.orientation * localWorldImuLinVel;
+  correctedWorldImuKine.angVel = correctedWorldImuPose.orientation * localWorldImuAngVel;
+  correctedWorldImuKine_ = correctedWorldImuKine.toKinematics();
+
+  correctedWorldFbKine_ =
+      (kinematicsTools::lazy(correctedWorldImuKine) * kinematicsTools::lazy(updatedFbImuKine_).inverse())
+          .evaluate<kinematicsTools::staticFields::poseAndVel>()
+          .toKinematics();
 
   velW_.linear() = correctedWorldFbKine_.linVel();
   velW_.angular() = correctedWorldFbKine_.angVel();
 
-  if(odometryManager_.odometryType_ != measurements::None)
+  if constexpr(withOdometry)
   {
     // the velocity of the odometry robot was obtained using finite differences. We give it our estimated velocity which
     // is more accurate.
@@ -553,14 +607,39 @@ void TiltObserver::updatePoseAndVel(const so::Vector3 & localWorldImuLinVel, con
   }
 }
 
+void TiltObserver::runBatch(mc_control::MCController & ctl,
+                           const batchTools::InputView & inputs,
+                           batchTools::OutputView outputs)
+{
+  if(!headless_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The batch processing requires a headless observer",
+                                                     observerName_);
+  }
+
+  // the run function is called without virtual dispatch, the estimation is read directly from the members
+  batchTools::runBatch(ctl, robot_, inputs, outputs, observerName_,
+                       [this, &ctl](sva::PTransformd & X, sva::MotionVecd & v)
+                       {
+                         TiltObserver::run(ctl);
+                         X = poseW_;
+                         v = velW_;
+                       });
+}
+
 void TiltObserver::update(mc_control::MCController & ctl)
 {
+  MCSO_TRACE_SCOPE("TiltObserver::update");
   auto & realRobot = ctl.realRobot(robot_);
   if(updateRobot_)
   {
-    update(realRobot);
-    realRobot.forwardKinematics();
-    realRobot.forwardVelocity();
+    if(jointsKinematicsUpdatedUpstream_) { kinematicsTools::updateFloatingBase(realRobot, poseW_, velW_); }
+    else
+    {
+      update(realRobot);
+      realRobot.forwardKinematics();
+      realRobot.forwardVelocity();
+    }
   }
 
   if(updateSensor_)
@@ -591,23 +670,26 @@ const so::kine::Kinematics TiltObserver::backupFb(const mc_control::MCController
 
   // so::kine::Kinematics worldResetKine = so::kine::Kinematics::zeroKinematics(so::kine::Kinematics::Flags::pose);
 
-  // original initial pose of the floating base
-  so::kine::Kinematics worldFbInitBackup =
-      kinematicsTools::poseFromSva(backupFbKinematics_.front(), so::kine::Kinematics::Flags::pose);
+  // the poses of the buffer are combined without the flags checks of the Kinematics, only the new pose of the floating
+  // base is converted
+  const kinematicsTools::PoseKinematics worldResetPose =
+      kinematicsTools::PoseKinematics::fromKinematics(worldResetKine);
 
-  so::kine::Kinematics fbWorldInitBackup = worldFbInitBackup.getInverse();
+  // original initial pose of the floating base
+  const kinematicsTools::PoseKinematics fbWorldInitBackup =
+      kinematicsTools::PoseKinematics::fromSva(backupFbKinematics_.front()).inverse();
 
   // we apply the transformation from the initial pose to the intermediates pose estimated by the tilt estimator to the
   // new starting pose of the Kinetics Observer
   for(int i = 0; i < koBackupFbKinematics->size(); i++)
   {
     // Intermediary pose of the floating base estimated by the tilt estimator
-    so::kine::Kinematics worldFbIntermBackup =
-        kinematicsTools::poseFromSva(backupFbKinematics_.at(i), so::kine::Kinematics::Flags::pose);
+    const kinematicsTools::PoseKinematics worldFbIntermBackup =
+        kinematicsTools::PoseKinematics::fromSva(backupFbKinematics_.at(i));
     // transformation between the initial and the intermediary pose during the backup interval
-    so::kine::Kinematics initInterm = fbWorldInitBackup * worldFbIntermBackup;
+    const kinematicsTools::PoseKinematics initInterm = fbWorldInitBackup * worldFbIntermBackup;
 
-    koBackupFbKinematics->at(i) = worldResetKine * initInterm;
+    koBackupFbKinematics->at(i) = (worldResetPose * initInterm).toKinematics();
   }
 
   so::Vector3 tiltLocalLinVel = poseW_.rotation() * velW_.linear();
@@ -678,6 +760,8 @@ void TiltObserver::addToLogger(const mc_control::MCController & ctl,
   logger.addLogEntry(category + "_constants_alpha", [this]() -> const double & { return alpha_; });
   logger.addLogEntry(category + "_constants_beta", [this]() -> const double & { return beta_; });
   logger.addLogEntry(category + "_constants_gamma", [this]() -> const double & { return gamma_; });
+  // the count of suppressed messages is shared by all the observers, it is logged once
+  logTools::addToLogger(logger);
 
   logger.addLogEntry(category + "_debug_OdometryType",
                      [this]() -> std::string
@@ -917,6 +1001,10 @@ void TiltObserver::addToLogger(const mc_control::MCController & ctl,
 
   kinematicsTools::addToLogger(updatedWorldFbKine_, logger, category + "_debug_updatedWorldFbKine_");
   kinematicsTools::addToLogger(correctedWorldImuKine_, logger, category + "_debug_correctedWorldImuKine_");
+
+  perfCounters_.addToLogger(logger, category);
+  golden_.addToLogger(logger, category);
+  memoryReport_.addToLogger(logger, category);
 }
 
 void TiltObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -925,6 +1013,10 @@ void TiltObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string &
   logger.removeLogEntry(category + "_imuPoseC");
   logger.removeLogEntry(category + "_imuEstRotW");
   logger.removeLogEntry(category + "_controlAnchorFrame");
+  logTools::removeFromLogger(logger);
+  perfCounters_.removeFromLogger(logger, category);
+  golden_.removeFromLogger(logger, category);
+  memoryReport_.removeFromLogger(logger, category);
 }
 
 void TiltObserver::addToGUI(const mc_control::MCController &,
@@ -947,6 +1039,8 @@ void TiltObserver::addToGUI(const mc_control::MCController &,
                        },
                        [this](const std::string & typeOfOdometry) { changeOdometryType(typeOfOdometry); }));
   }
+
+  memoryReport_.addToGUI(gui, category, [this]() { memoryReport_.refresh(); });
 }
 
 } // namespace mc_state_observation
@@ -0,0 +1,79 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/asyncTools.h>
+
+#include <stdexcept>
+
+namespace mc_state_observation
+{
+namespace asyncTools
+{
+
+AsyncTask::~AsyncTask()
+{
+  if(!started()) { return; }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  launchCv_.notify_one();
+  thread_.join();
+}
+
+void AsyncTask::start(std::function<void()> task,
+                      const threadTools::ThreadConfiguration & config,
+                      const std::string & owner)
+{
+  if(started())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The worker thread of the task is already started", owner);
+  }
+  task_ = std::move(task);
+  owner_ = owner;
+  thread_ = threadTools::startThread(config, owner, [this]() { workerLoop(); });
+}
+
+void AsyncTask::launch()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(running_.load(std::memory_order_relaxed))
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The task is launched while still running", owner_);
+    }
+    running_.store(true, std::memory_order_relaxed);
+    launched_ = true;
+  }
+  launchCv_.notify_one();
+}
+
+void AsyncTask::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCv_.wait(lock, [this]() { return !running_.load(std::memory_order_relaxed); });
+}
+
+void AsyncTask::workerLoop()
+{
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      launchCv_.wait(lock, [this]() { return stop_ || launched_; });
+      // a launched task is completed before stopping, so wait() never blocks forever
+      if(!launched_) { return; }
+      launched_ = false;
+    }
+
+    task_();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // the writes of the task are visible to the thread observing the end of the task
+      running_.store(false, std::memory_order_release);
+    }
+    doneCv_.notify_all();
+  }
+}
+
+} // namespace asyncTools
+} // namespace mc_state_observation
@@ -0,0 +1,97 @@
+#include <mc_state_observation/observersTools/batchTools.h>
+
+namespace mc_state_observation
+{
+namespace batchTools
+{
+
+InputsWriter::InputsWriter(mc_control::MCController & ctl,
+                           const std::string & robotName,
+                           const InputView & inputs,
+                           const std::string & owner)
+: robot_(ctl.robot(robotName)), realRobot_(ctl.realRobot(robotName)), inputs_(inputs)
+{
+  const auto nbIters = inputs.size();
+  const auto nbJoints = static_cast<Eigen::Index>(robot_.refJointOrder().size());
+  const auto nbBodySensors = static_cast<Eigen::Index>(robot_.bodySensors().size());
+  const auto nbForceSensors = static_cast<Eigen::Index>(robot_.forceSensors().size());
+
+  auto checkSize = [&](const Eigen::MatrixXd & measurements, Eigen::Index rows, const char * name)
+  {
+    if(measurements.rows() != rows || measurements.cols() != nbIters)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "[{}] The recorded {} must have {} rows and {} columns (one per iteration), got {}x{}", owner, name, rows,
+          nbIters, measurements.rows(), measurements.cols());
+    }
+  };
+  checkSize(inputs.encoders, nbJoints, "encoders");
+  if(inputs.encoderVelocities.size() > 0) { checkSize(inputs.encoderVelocities, nbJoints, "encoder velocities"); }
+  checkSize(inputs.gyrometers, 3 * nbBodySensors, "gyrometers");
+  checkSize(inputs.accelerometers, 3 * nbBodySensors, "accelerometers");
+  checkSize(inputs.wrenches, 6 * nbForceSensors, "wrenches");
+
+  mbcIndices_.resize(robot_.refJointOrder().size());
+  for(size_t i = 0; i < mbcIndices_.size(); i++) { mbcIndices_[i] = realRobot_.jointIndexInMBC(i); }
+  encoders_.resize(mbcIndices_.size());
+  encoderVelocities_.resize(mbcIndices_.size());
+}
+
+void InputsWriter::write(Eigen::Index iter)
+{
+  /* Encoders */
+
+  const auto encoders = inputs_.encoders.col(iter);
+  const bool withVelocities = inputs_.encoderVelocities.size() > 0;
+  auto & q = realRobot_.mbc().q;
+  auto & alpha = realRobot_.mbc().alpha;
+  for(size_t i = 0; i < mbcIndices_.size(); i++)
+  {
+    const auto row = static_cast<Eigen::Index>(i);
+    encoders_[i] = encoders(row);
+    if(withVelocities) { encoderVelocities_[i] = inputs_.encoderVelocities(row, iter); }
+
+    const int mbcIndex = mbcIndices_[i];
+    if(mbcIndex < 0) { continue; }
+    q[static_cast<size_t>(mbcIndex)][0] = encoders_[i];
+    if(withVelocities) { alpha[static_cast<size_t>(mbcIndex)][0] = encoderVelocities_[i]; }
+  }
+  robot_.encoderValues(encoders_);
+  realRobot_.encoderValues(encoders_);
+  if(withVelocities)
+  {
+    robot_.encoderVelocities(encoderVelocities_);
+    realRobot_.encoderVelocities(encoderVelocities_);
+  }
+
+  /* Body sensors */
+
+  auto & bodySensors = robot_.bodySensors();
+  auto & realBodySensors = realRobot_.bodySensors();
+  for(size_t i = 0; i < bodySensors.size(); i++)
+  {
+    const Eigen::Vector3d gyro = inputs_.gyrometers.block<3, 1>(3 * static_cast<Eigen::Index>(i), iter);
+    const Eigen::Vector3d acc = inputs_.accelerometers.block<3, 1>(3 * static_cast<Eigen::Index>(i), iter);
+    bodySensors[i].angularVelocity(gyro);
+    bodySensors[i].linearAcceleration(acc);
+    realBodySensors[i].angularVelocity(gyro);
+    realBodySensors[i].linearAcceleration(acc);
+  }
+
+  /* Force sensors */
+
+  auto & forceSensors = robot_.forceSensors();
+  auto & realForceSensors = realRobot_.forceSensors();
+  for(size_t i = 0; i < forceSensors.size(); i++)
+  {
+    const sva::ForceVecd wrench(inputs_.wrenches.block<6, 1>(6 * static_cast<Eigen::Index>(i), iter));
+    forceSensors[i].wrench(wrench);
+    realForceSensors[i].wrench(wrench);
+  }
+
+  realRobot_.forwardKinematics();
+  if(withVelocities) { realRobot_.forwardVelocity(); }
+}
+
+} // namespace batchTools
+} // namespace mc_state_observation
@@ -0,0 +1,220 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/flightRecorder.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+namespace mc_state_observation
+{
+namespace flightRecorder
+{
+
+namespace
+{
+constexpr char magic[8] = {'M', 'C', 'S', 'O', 'F', 'R', '0', '1'};
+
+template<typename T>
+void writeValue(std::ofstream & file, const T & value)
+{
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+T readValue(std::ifstream & file)
+{
+  T value;
+  file.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return value;
+}
+} // namespace
+
+FlightRecorder::~FlightRecorder()
+{
+  if(thread_.joinable())
+  {
+    stop_ = true;
+    cv_.notify_one();
+    thread_.join();
+  }
+}
+
+void FlightRecorder::init(const std::string & name,
+                          const std::string & directory,
+                          const std::vector<Block> & blocks,
+                          size_t capacity,
+                          const threadTools::ThreadConfiguration & threadConfig)
+{
+  if(initialized_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The flight recorder is already initialized", name);
+  }
+  if(capacity == 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The flight recorder must have a non-zero capacity", name);
+  }
+
+  name_ = name;
+  directory_ = directory;
+  blocks_ = blocks;
+  capacity_ = capacity;
+
+  recordSize_ = 1; // time of the record
+  for(const auto & block : blocks_) { recordSize_ += block.size; }
+
+  buffer_.resize(recordSize_ * capacity_);
+  head_ = 0;
+  count_ = 0;
+
+  initialized_ = true;
+  thread_ = threadTools::startThread(threadConfig, name_, [this]() { dumpLoop(); });
+
+  mc_rtc::log::info("[{}] Flight recorder allocated {:.1f} MB ({} records of {} values), dumps written in {}", name_,
+                    static_cast<double>(bufferSize()) / 1e6, capacity_, recordSize_, directory_);
+}
+
+void FlightRecorder::record(double t, std::initializer_list<const Eigen::VectorXd *> blocks)
+{
+  if(!initialized_) { return; }
+  // the dump thread currently reads the buffer
+  if(frozen_.load(std::memory_order_acquire))
+  {
+    ++dropped_;
+    return;
+  }
+
+  assert(blocks.size() == blocks_.size());
+
+  double * slot = buffer_.data() + head_ * recordSize_;
+  *slot++ = t;
+  auto blockDesc = blocks_.begin();
+  for(const Eigen::VectorXd * block : blocks)
+  {
+    assert(block->size() == blockDesc->size);
+    std::memcpy(slot, block->data(), blockDesc->size * sizeof(double));
+    slot += blockDesc->size;
+    ++blockDesc;
+  }
+
+  head_ = (head_ + 1) % capacity_;
+  if(count_ < capacity_) { ++count_; }
+}
+
+bool FlightRecorder::requestDump(const char * reason)
+{
+  if(!initialized_) { return false; }
+
+  bool expected = false;
+  // a dump is already ongoing
+  if(!frozen_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) { return false; }
+
+  reason_.store(reason, std::memory_order_release);
+  cv_.notify_one();
+  return true;
+}
+
+void FlightRecorder::dumpLoop()
+{
+  while(!stop_)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      // the real-time thread doesn't take the lock when notifying, the timeout avoids missing a request
+      cv_.wait_for(lock, std::chrono::milliseconds(100),
+                   [this]() { return stop_ || reason_.load(std::memory_order_acquire) != nullptr; });
+    }
+    if(reason_.load(std::memory_order_acquire) == nullptr) { continue; }
+
+    writeFile();
+
+    reason_.store(nullptr, std::memory_order_release);
+    frozen_.store(false, std::memory_order_release);
+  }
+}
+
+void FlightRecorder::writeFile()
+{
+  const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y%m%d-%H%M%S", std::localtime(&now));
+  const std::string path =
+      fmt::format("{}/{}-flightRecorder-{}-{}.bin", directory_, name_, date, reason_.load(std::memory_order_acquire));
+
+  std::ofstream file(path, std::ios::binary);
+  if(!file)
+  {
+    mc_rtc::log::error("[{}] Could not open {} to dump the flight recorder", name_, path);
+    return;
+  }
+
+  file.write(magic, sizeof(magic));
+  writeValue(file, static_cast<uint32_t>(blocks_.size()));
+  for(const auto & block : blocks_)
+  {
+    writeValue(file, static_cast<uint32_t>(block.name.size()));
+    file.write(block.name.data(), static_cast<std::streamsize>(block.name.size()));
+    writeValue(file, block.size);
+  }
+  writeValue(file, static_cast<uint64_t>(count_));
+
+  // oldest records first: if the buffer is full, the oldest one is located at the head.
+  const size_t oldest = count_ < capacity_ ? 0 : head_;
+  const size_t firstChunk = std::min(count_, capacity_ - oldest);
+  file.write(reinterpret_cast<const char *>(buffer_.data() + oldest * recordSize_),
+             static_cast<std::streamsize>(firstChunk * recordSize_ * sizeof(double)));
+  file.write(reinterpret_cast<const char *>(buffer_.data()),
+             static_cast<std::streamsize>((count_ - firstChunk) * recordSize_ * sizeof(double)));
+
+  if(!file)
+  {
+    mc_rtc::log::error("[{}] Failed to write the flight recorder to {}", name_, path);
+    return;
+  }
+
+  ++dumps_;
+  mc_rtc::log::success("[{}] Flight recorder dumped {} records to {}", name_, count_, path);
+}
+
+void FlightRecorder::load(const std::string & path,
+                          std::vector<Block> & blocks,
+                          std::vector<double> & times,
+                          Eigen::MatrixXd & records)
+{
+  std::ifstream file(path, std::ios::binary);
+  if(!file) { mc_rtc::log::error_and_throw<std::runtime_error>("Could not open the flight record {}", path); }
+
+  char fileMagic[sizeof(magic)];
+  file.read(fileMagic, sizeof(fileMagic));
+  if(!file || std::memcmp(fileMagic, magic, sizeof(magic)) != 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("{} is not a flight record", path);
+  }
+
+  blocks.resize(readValue<uint32_t>(file));
+  Eigen::Index recordSize = 0;
+  for(auto & block : blocks)
+  {
+    block.name.resize(readValue<uint32_t>(file));
+    file.read(&block.name[0], static_cast<std::streamsize>(block.name.size()));
+    block.size = readValue<uint32_t>(file);
+    recordSize += block.size;
+  }
+  const auto nbRecords = static_cast<Eigen::Index>(readValue<uint64_t>(file));
+
+  times.resize(static_cast<size_t>(nbRecords));
+  records.resize(recordSize, nbRecords);
+  for(Eigen::Index i = 0; i < nbRecords; ++i)
+  {
+    times[static_cast<size_t>(i)] = readValue<double>(file);
+    file.read(reinterpret_cast<char *>(records.col(i).data()),
+              static_cast<std::streamsize>(recordSize * static_cast<Eigen::Index>(sizeof(double))));
+  }
+
+  if(!file) { mc_rtc::log::error_and_throw<std::runtime_error>("The flight record {} is truncated", path); }
+}
+
+} // namespace flightRecorder
+} // namespace mc_state_observation
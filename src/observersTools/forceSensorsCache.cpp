@@ -0,0 +1,117 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/forceSensorsCache.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace mc_state_observation
+{
+namespace forceSensorsCache
+{
+
+std::shared_ptr<ForceSensorsCache> ForceSensorsCache::shared(const mc_control::MCController & ctl,
+                                                            const std::string & robotName)
+{
+  // the caches are owned by the observers, the registry only allows them to find each other. Several controllers can
+  // run in parallel (processing of logs), so the registry is protected.
+  static std::mutex registryMutex;
+  static std::map<std::pair<const mc_control::MCController *, std::string>, std::weak_ptr<ForceSensorsCache>> registry;
+
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for(auto it = registry.begin(); it != registry.end();)
+  {
+    if(it->second.expired()) { it = registry.erase(it); }
+    else { ++it; }
+  }
+
+  auto & entry = registry[{&ctl, robotName}];
+  auto cache = entry.lock();
+  if(!cache)
+  {
+    cache = std::make_shared<ForceSensorsCache>();
+    entry = cache;
+  }
+  return cache;
+}
+
+size_t ForceSensorsCache::addReader()
+{
+  iteratingReaders_.push_back(false);
+  return iteratingReaders_.size() - 1;
+}
+
+void ForceSensorsCache::newIteration(size_t reader)
+{
+  if(iteratingReaders_.at(reader))
+  {
+    // the reader already started the current iteration of the controller, a new one starts
+    std::fill(iteratingReaders_.begin(), iteratingReaders_.end(), false);
+    upToDate_ = false;
+  }
+  iteratingReaders_[reader] = true;
+}
+
+const ForceSensorsCache & ForceSensorsCache::measurements(const mc_rbdyn::Robot & robot)
+{
+  if(!upToDate_) { update(robot, robot); }
+  return *this;
+}
+
+void ForceSensorsCache::update(const mc_rbdyn::Robot & sensorsRobot, const mc_rbdyn::Robot & kinematicsRobot)
+{
+  if(sensorsRobot.name() != sensorsRobotName_ || kinematicsRobot.name() != kinematicsRobotName_
+     || sensorsRobot.forceSensors().size() != sensors_.size())
+  {
+    resolveIndices(sensorsRobot, kinematicsRobot);
+  }
+
+  const auto & forceSensors = sensorsRobot.forceSensors();
+  const sva::PTransformd & X_0_fb = kinematicsRobot.posW();
+  for(size_t i = 0; i < sensors_.size(); i++)
+  {
+    const mc_rbdyn::ForceSensor & forceSensor = forceSensors[i];
+    ForceSensorMeasurements & measurements = sensors_[i];
+
+    measurements.wrench_ = forceSensor.wrench();
+    measurements.wrenchWithoutGravity_ = forceSensor.wrenchWithoutGravity(kinematicsRobot);
+    measurements.forceNorm_ = measurements.wrenchWithoutGravity_.force().norm();
+
+    // pose of the sensor in the world, the wrench is first expressed in the world then in the floating base
+    const sva::PTransformd X_0_s = forceSensor.X_p_f() * kinematicsRobot.mbc().bodyPosW[parentIndices_[i]];
+    measurements.fbWrenchWithoutGravity_ = X_0_fb.dualMul(X_0_s.transMul(measurements.wrenchWithoutGravity_));
+  }
+  upToDate_ = true;
+}
+
+const ForceSensorMeasurements & ForceSensorsCache::operator()(const std::string & sensorName) const
+{
+  auto it = indices_.find(sensorName);
+  if(it == indices_.end())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ForceSensorsCache] The force sensor {} doesn't exist in {}",
+                                                     sensorName, sensorsRobotName_);
+  }
+  return sensors_[it->second];
+}
+
+void ForceSensorsCache::resolveIndices(const mc_rbdyn::Robot & sensorsRobot, const mc_rbdyn::Robot & kinematicsRobot)
+{
+  sensorsRobotName_ = sensorsRobot.name();
+  kinematicsRobotName_ = kinematicsRobot.name();
+
+  const auto & forceSensors = sensorsRobot.forceSensors();
+  sensors_.resize(forceSensors.size());
+  parentIndices_.resize(forceSensors.size());
+  indices_.clear();
+  for(size_t i = 0; i < forceSensors.size(); i++)
+  {
+    sensors_[i].name_ = forceSensors[i].name();
+    parentIndices_[i] = kinematicsRobot.bodyIndexByName(forceSensors[i].parentBody());
+    indices_[forceSensors[i].name()] = i;
+  }
+}
+
+} // namespace forceSensorsCache
+} // namespace mc_state_observation
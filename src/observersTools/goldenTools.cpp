@@ -0,0 +1,199 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/goldenTools.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace mc_state_observation
+{
+namespace goldenTools
+{
+
+namespace
+{
+
+constexpr const char * signalNames[] = {"position", "orientation", "linVel", "angVel"};
+
+} // namespace
+
+GoldenTrajectory::~GoldenTrajectory()
+{
+  finish();
+}
+
+void GoldenTrajectory::configure(const mc_rtc::Configuration & config, const std::string & owner)
+{
+  owner_ = owner;
+  const std::string mode = config("mode", std::string("compare"));
+  if(mode == "record") { mode_ = Mode::record; }
+  else if(mode == "compare") { mode_ = Mode::compare; }
+  else
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] Unknown golden trajectory mode {}. Available: record, compare", owner, mode);
+  }
+  file_ = static_cast<std::string>(config("file"));
+
+  if(config.has("tolerances"))
+  {
+    auto tolerancesConfig = config("tolerances");
+    for(size_t i = 0; i < nbSignals; i++) { tolerancesConfig(signalNames[i], tolerances_[i]); }
+  }
+  config("relative", relativeTolerances_);
+
+  samples_.clear();
+  iter_ = 0;
+  finished_ = false;
+  success_ = true;
+
+  if(mode_ == Mode::record)
+  {
+    mc_rtc::log::info("[{}] Recording the golden trajectory to {}", owner_, file_);
+    return;
+  }
+
+  std::ifstream file(file_);
+  if(!file)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Could not open the golden trajectory {}", owner, file_);
+  }
+  Sample sample;
+  while(true)
+  {
+    for(auto & value : sample) { file >> value; }
+    if(!file) { break; }
+    samples_.push_back(sample);
+  }
+  mc_rtc::log::info("[{}] Comparing the estimation to the golden trajectory {} ({} iterations)", owner_, file_,
+                    samples_.size());
+}
+
+void GoldenTrajectory::add(const sva::PTransformd & X, const sva::MotionVecd & v, double duration)
+{
+  duration_ = duration;
+  totalDuration_ += duration_;
+
+  const Eigen::Quaterniond q(X.rotation().transpose());
+
+  if(mode_ == Mode::record)
+  {
+    const Eigen::Vector3d & t = X.translation();
+    samples_.push_back({t.x(), t.y(), t.z(), q.w(), q.x(), q.y(), q.z(), v.linear().x(), v.linear().y(),
+                        v.linear().z(), v.angular().x(), v.angular().y(), v.angular().z(), duration_});
+    ++iter_;
+    return;
+  }
+
+  if(iter_ >= samples_.size())
+  {
+    // the sequence is longer than the golden one, the extra iterations are not compared
+    ++iter_;
+    return;
+  }
+
+  const Sample & golden = samples_[iter_];
+  const Eigen::Vector3d goldenPosition(golden[0], golden[1], golden[2]);
+  const Eigen::Quaterniond goldenQ(golden[3], golden[4], golden[5], golden[6]);
+  const Eigen::Vector3d goldenLinVel(golden[7], golden[8], golden[9]);
+  const Eigen::Vector3d goldenAngVel(golden[10], golden[11], golden[12]);
+  errors_[position] = (X.translation() - goldenPosition).norm();
+  errors_[orientation] = q.angularDistance(goldenQ);
+  errors_[linVel] = (v.linear() - goldenLinVel).norm();
+  errors_[angVel] = (v.angular() - goldenAngVel).norm();
+  totalGoldenDuration_ += golden[13];
+
+  // the orientation error is an angle, its tolerance is always absolute
+  std::array<double, nbSignals> scales = {1.0, 1.0, 1.0, 1.0};
+  if(relativeTolerances_)
+  {
+    scales[position] = std::max(goldenPosition.norm(), 1.0);
+    scales[linVel] = std::max(goldenLinVel.norm(), 1.0);
+    scales[angVel] = std::max(goldenAngVel.norm(), 1.0);
+  }
+
+  for(size_t i = 0; i < nbSignals; i++)
+  {
+    // a NaN is always a violation
+    if(!(errors_[i] <= tolerances_[i] * scales[i])) { ++violations_[i]; }
+    if(!(errors_[i] <= maxErrors_[i])) { maxErrors_[i] = errors_[i]; }
+  }
+  ++iter_;
+}
+
+bool GoldenTrajectory::finish()
+{
+  if(!enabled() || finished_) { return success_; }
+  finished_ = true;
+
+  if(mode_ == Mode::record)
+  {
+    std::ofstream file(file_);
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for(const auto & sample : samples_)
+    {
+      for(size_t i = 0; i < sample.size(); i++) { file << (i == 0 ? "" : " ") << sample[i]; }
+      file << "\n";
+    }
+    if(!file)
+    {
+      mc_rtc::log::error("[{}] Failed to write the golden trajectory to {}", owner_, file_);
+      success_ = false;
+      return success_;
+    }
+    mc_rtc::log::success("[{}] Golden trajectory of {} iterations written to {} (mean duration {:.1f} us)", owner_,
+                         iter_, file_, iter_ > 0 ? totalDuration_ / static_cast<double>(iter_) * 1e6 : 0.0);
+    return success_;
+  }
+
+  const size_t compared = std::min(iter_, samples_.size());
+  success_ = iter_ == samples_.size();
+  std::string summary;
+  for(size_t i = 0; i < nbSignals; i++)
+  {
+    success_ = success_ && violations_[i] == 0;
+    summary += fmt::format("\n  {}: max error {:.3e} (tolerance {:.3e}), {} violations", signalNames[i], maxErrors_[i],
+                           tolerances_[i], violations_[i]);
+  }
+  summary += fmt::format("\n  mean duration: {:.1f} us",
+                         iter_ > 0 ? totalDuration_ / static_cast<double>(iter_) * 1e6 : 0.0);
+  // the golden trajectories giving the ground truth of a synthetic sequence have no duration
+  if(totalGoldenDuration_ > 0.0)
+  {
+    summary += fmt::format(" (golden: {:.1f} us)", totalGoldenDuration_ / static_cast<double>(compared) * 1e6);
+  }
+
+  if(success_)
+  {
+    mc_rtc::log::success("[{}] The estimation matches the golden trajectory {} ({} iterations):{}", owner_, file_,
+                         iter_, summary);
+  }
+  else
+  {
+    mc_rtc::log::error("[{}] The estimation differs from the golden trajectory {} ({} iterations, {} golden):{}",
+                       owner_, file_, iter_, samples_.size(), summary);
+  }
+  return success_;
+}
+
+void GoldenTrajectory::addToLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  if(!enabled()) { return; }
+  logger.addLogEntry(category + "_golden_duration", [this]() -> double { return duration_; });
+  if(mode_ != Mode::compare) { return; }
+  for(size_t i = 0; i < nbSignals; i++)
+  {
+    logger.addLogEntry(category + "_golden_error_" + signalNames[i], [this, i]() -> double { return errors_[i]; });
+  }
+}
+
+void GoldenTrajectory::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  logger.removeLogEntry(category + "_golden_duration");
+  for(size_t i = 0; i < nbSignals; i++) { logger.removeLogEntry(category + "_golden_error_" + signalNames[i]); }
+}
+
+} // namespace goldenTools
+} // namespace mc_state_observation
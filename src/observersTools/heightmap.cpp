@@ -0,0 +1,129 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/heightmap.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace mc_state_observation
+{
+namespace heightmap
+{
+
+namespace
+{
+
+constexpr char magic[] = "MCSOHMAP";
+
+} // namespace
+
+Heightmap::Heightmap(const Eigen::Vector2d & origin, double resolution, const Eigen::MatrixXd & heights)
+: origin_(origin), resolution_(resolution), heights_(heights)
+{
+  check("the given grid");
+}
+
+void Heightmap::configure(const mc_rtc::Configuration & config, const std::string & owner)
+{
+  owner_ = owner;
+  datastoreKey_.clear();
+  heights_.resize(0, 0);
+  cachedI_ = -1;
+  cachedJ_ = -1;
+
+  if(config.has("file")) { load(static_cast<std::string>(config("file"))); }
+  else if(config.has("datastore")) { datastoreKey_ = static_cast<std::string>(config("datastore")); }
+  else
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] The heightmap must be given either by a file (file) or by the datastore (datastore)", owner_);
+  }
+}
+
+void Heightmap::resolve(const mc_control::MCController & ctl)
+{
+  if(datastoreKey_.empty()) { return; }
+  if(!ctl.datastore().has(datastoreKey_))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The heightmap {} is not in the datastore", owner_,
+                                                     datastoreKey_);
+  }
+  const auto & heightmap = ctl.datastore().get<Heightmap>(datastoreKey_);
+  origin_ = heightmap.origin_;
+  resolution_ = heightmap.resolution_;
+  heights_ = heightmap.heights_;
+  cachedI_ = -1;
+  cachedJ_ = -1;
+  check(datastoreKey_);
+  mc_rtc::log::info("[{}] Heightmap of {}x{} nodes retrieved from the datastore entry {}", owner_, heights_.rows(),
+                    heights_.cols(), datastoreKey_);
+}
+
+void Heightmap::load(const std::string & file)
+{
+  std::ifstream stream(file, std::ios::binary);
+  if(!stream)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Could not open the heightmap {}", owner_, file);
+  }
+
+  char header[sizeof(magic) - 1];
+  uint32_t nx = 0;
+  uint32_t ny = 0;
+  stream.read(header, sizeof(header));
+  stream.read(reinterpret_cast<char *>(&nx), sizeof(nx));
+  stream.read(reinterpret_cast<char *>(&ny), sizeof(ny));
+  stream.read(reinterpret_cast<char *>(origin_.data()), 2 * sizeof(double));
+  stream.read(reinterpret_cast<char *>(&resolution_), sizeof(double));
+  if(!stream || std::memcmp(header, magic, sizeof(header)) != 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] {} is not a valid heightmap", owner_, file);
+  }
+
+  // the heights are stored with x varying first, as the column-major storage of Eigen
+  heights_.resize(nx, ny);
+  stream.read(reinterpret_cast<char *>(heights_.data()),
+              static_cast<std::streamsize>(heights_.size() * static_cast<Eigen::Index>(sizeof(double))));
+  if(!stream)
+  {
+    heights_.resize(0, 0);
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The heightmap {} is truncated", owner_, file);
+  }
+  cachedI_ = -1;
+  cachedJ_ = -1;
+  check(file);
+  mc_rtc::log::info("[{}] Heightmap of {}x{} nodes loaded from {}", owner_, nx, ny, file);
+}
+
+void Heightmap::cacheCell(Eigen::Index i, Eigen::Index j) const
+{
+  // a grid with a single node along an axis is constant along it
+  const Eigen::Index i1 = std::min(i + 1, heights_.rows() - 1);
+  const Eigen::Index j1 = std::min(j + 1, heights_.cols() - 1);
+
+  const double h00 = heights_(i, j);
+  const double h10 = heights_(i1, j);
+  const double h01 = heights_(i, j1);
+  const double h11 = heights_(i1, j1);
+  coeffs_ << h00, h10 - h00, h01 - h00, h00 - h10 - h01 + h11;
+
+  cachedI_ = i;
+  cachedJ_ = j;
+}
+
+void Heightmap::check(const std::string & source) const
+{
+  if(heights_.size() == 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The heightmap from {} is empty", owner_, source);
+  }
+  if(!(resolution_ > 0.0))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The resolution of the heightmap from {} must be positive",
+                                                     owner_, source);
+  }
+}
+
+} // namespace heightmap
+} // namespace mc_state_observation
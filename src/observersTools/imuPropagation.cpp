@@ -0,0 +1,48 @@
+#include <mc_state_observation/observersTools/imuPropagation.h>
+
+namespace so = stateObservation;
+
+namespace mc_state_observation
+{
+namespace imuPropagation
+{
+
+void ImuPropagator::reset(const so::kine::Kinematics & worldFbKine, const so::Vector3 & gyroBias)
+{
+  worldFbKine_.position = worldFbKine.position();
+  worldFbKine_.orientation = worldFbKine.orientation;
+  worldFbKine_.linVel = worldFbKine.linVel();
+  worldFbKine_.angVel = worldFbKine.angVel();
+  worldFbKine_.linAcc = so::Vector3::Zero();
+  worldFbKine_.angAcc = so::Vector3::Zero();
+  gyroBias_ = gyroBias;
+}
+
+void ImuPropagator::propagate(const so::kine::Kinematics & fbImuKine,
+                              const so::Vector3 & gyro,
+                              const so::Vector3 & acc,
+                              double dt,
+                              bool withAccelerometer)
+{
+  const so::Matrix3 worldFbOri = worldFbKine_.orientation.toMatrix3();
+  const so::Matrix3 fbImuOri = fbImuKine.orientation.toMatrix3();
+
+  // the gyrometer measures the angular velocity of the IMU, which includes the one due to the joints
+  worldFbKine_.angVel = so::Vector3(worldFbOri * (fbImuOri * (gyro - gyroBias_) - fbImuKine.angVel()));
+  worldFbKine_.angAcc = so::Vector3::Zero();
+  worldFbKine_.linAcc = so::Vector3::Zero();
+
+  if(withAccelerometer)
+  {
+    // acceleration the IMU would have if the floating base had no linear acceleration
+    const so::kine::Kinematics worldImuKine = worldFbKine_ * fbImuKine;
+    const so::Vector3 imuLinAcc =
+        worldFbOri * fbImuOri * acc - so::cst::gravityConstant * so::Vector3::UnitZ();
+    worldFbKine_.linAcc = so::Vector3(imuLinAcc - worldImuKine.linAcc());
+  }
+
+  worldFbKine_.integrate(dt);
+}
+
+} // namespace imuPropagation
+} // namespace mc_state_observation
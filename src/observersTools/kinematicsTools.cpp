@@ -186,5 +186,58 @@ sva::PTransformd pTransformFromKinematics(const so::kine::Kinematics & kine)
   return pose;
 }
 
+///////////////////////////////////////////////////////////////////////
+/// ---------------------Update of the robot kinematics-----------------
+///////////////////////////////////////////////////////////////////////
+
+void updateFloatingBase(mc_rbdyn::Robot & robot, const sva::PTransformd & X_0_fb, const sva::MotionVecd & v_fb_0)
+{
+  if(robot.mb().joint(0).type() != rbd::Joint::Type::Free)
+  {
+    robot.posW(X_0_fb);
+    robot.velW(v_fb_0);
+    robot.forwardKinematics();
+    robot.forwardVelocity();
+    return;
+  }
+
+  auto & mbc = robot.mbc();
+  const auto & rootJoint = robot.mb().joint(0);
+
+  // previous pose of the root body in the world
+  const sva::PTransformd X_0_root_prev = mbc.bodyPosW[0];
+
+  /* Configuration of the free joint, as done by mc_rbdyn::Robot::posW */
+  Eigen::Quaterniond ori(X_0_fb.rotation().transpose());
+  ori.normalize();
+  mbc.q[0] = {ori.w(), ori.x(), ori.y(), ori.z(), X_0_fb.translation().x(), X_0_fb.translation().y(),
+              X_0_fb.translation().z()};
+  mbc.jointConfig[0] = rootJoint.pose(mbc.q[0]);
+  mbc.parentToSon[0] = mbc.jointConfig[0] * robot.mb().transform(0);
+
+  /* Velocity of the free joint, expressed in the frame of the root body as done by mc_rbdyn::Robot::velW */
+  const sva::MotionVecd rootVelB = sva::PTransformd(mbc.parentToSon[0].rotation()) * v_fb_0;
+  mbc.alpha[0] = {rootVelB.angular().x(), rootVelB.angular().y(), rootVelB.angular().z(),
+                  rootVelB.linear().x(),  rootVelB.linear().y(),  rootVelB.linear().z()};
+  mbc.jointVelocity[0] = rootJoint.motion(mbc.alpha[0]);
+  const sva::MotionVecd rootVelBDiff = mbc.jointVelocity[0] - mbc.bodyVelB[0];
+
+  // rigid transformation from the previous world kinematics of the bodies to the new ones
+  const sva::PTransformd X_root_prev_inv = X_0_root_prev.inv();
+  const sva::PTransformd X_prev_new = X_root_prev_inv * mbc.parentToSon[0];
+
+  for(size_t i = 0; i < mbc.bodyPosW.size(); i++)
+  {
+    // pose of the body in the frame of the root body, unchanged by the update
+    const sva::PTransformd X_root_i = mbc.bodyPosW[i] * X_root_prev_inv;
+
+    mbc.bodyPosW[i] = mbc.bodyPosW[i] * X_prev_new;
+    // the velocity of the body relative to the root body is unchanged, only the contribution of the velocity of the
+    // root changes
+    mbc.bodyVelB[i] = mbc.bodyVelB[i] + X_root_i * rootVelBDiff;
+    mbc.bodyVelW[i] = sva::PTransformd(mbc.bodyPosW[i].rotation()).invMul(mbc.bodyVelB[i]);
+  }
+}
+
 } // namespace kinematicsTools
 } // namespace mc_state_observation
@@ -21,7 +21,8 @@ void LeggedOdometryManager::init(const mc_control::MCController & ctl,
                                  const bool velUpdatedUpstream,
                                  const bool accUpdatedUpstream,
                                  const bool verbose,
-                                 const bool withModeSwitchInGui)
+                                 const bool withModeSwitchInGui,
+                                 const bool headless)
 {
   robotName_ = robotName;
   odometryType_ = odometryType;
@@ -29,13 +30,14 @@ void LeggedOdometryManager::init(const mc_control::MCController & ctl,
   odometryName_ = odometryName;
   velUpdatedUpstream_ = velUpdatedUpstream;
   accUpdatedUpstream_ = accUpdatedUpstream;
+  headless_ = headless;
   const auto & robot = ctl.robot(robotName);
   odometryRobot_ = mc_rbdyn::Robots::make();
   odometryRobot_->robotCopy(robot, "odometryRobot");
 
   fbPose_.translation() = robot.posW().translation();
   fbPose_.rotation() = robot.posW().rotation();
-  contactsManager_.init(odometryName, verbose);
+  contactsManager_.init(odometryName, verbose, !headless);
 
   if(!ctl.datastore().has("KinematicAnchorFrame::" + ctl.robot(robotName).name()))
   {
@@ -55,6 +57,8 @@ void LeggedOdometryManager::init(const mc_control::MCController & ctl,
                                      so::kine::Kinematics::Flags::pose);
   }
 
+  if(headless_) { return; }
+
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
   logger.addLogEntry(odometryName_ + "_odometryRobot_posW",
                      [this]() -> sva::PTransformd { return odometryRobot().posW(); });
@@ -103,6 +107,7 @@ void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
 {
   contactsManager_.initDetection(ctl, robotName, contactsDetection, surfacesForContactDetection,
                                  contactsSensorDisabledInit, contactsDetectionThreshold);
+  selectContactsKinematicsStrategies();
 }
 
 void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
@@ -114,6 +119,23 @@ void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
 {
   contactsManager_.initDetection(ctl, robotName, contactsDetection, contactsSensorDisabledInit,
                                  contactsDetectionThreshold, forceSensorsToOmit);
+  selectContactsKinematicsStrategies();
+}
+
+void LeggedOdometryManager::selectContactsKinematicsStrategies()
+{
+  // If the contacts are not detected using surfaces, we must consider that the frame of the sensor is the one of the
+  // surface.
+  if(contactsManager_.getContactsDetection() == ContactsManager::ContactsDetection::fromThreshold)
+  {
+    newContactKinematicsSetter_ = &LeggedOdometryManager::setNewContactFromSensor;
+    currentContactKinematicsGetter_ = &LeggedOdometryManager::currentContactKinematicsFromSensor;
+  }
+  else
+  {
+    newContactKinematicsSetter_ = &LeggedOdometryManager::setNewContactFromSurface;
+    currentContactKinematicsGetter_ = &LeggedOdometryManager::currentContactKinematicsFromSurface;
+  }
 }
 
 void LeggedOdometryManager::updateJointsConfiguration(const mc_control::MCController & ctl)
@@ -400,10 +422,12 @@ void LeggedOdometryManager::updateFbAndContacts(const mc_control::MCController &
       LoContactWithSensor & foundContact = contactsManager_.contactWithSensor(foundContactIndex);
 
       setNewContact(foundContact, robot);
-      addContactLogEntries(logger, foundContact);
+      if(!headless_) { addContactLogEntries(logger, foundContact); }
     }
   }
 
+  if(headless_) { return; }
+
   for(auto & removedContactIndex : contactsManager().removedContacts())
   {
     LoContactWithSensor & removedContact = contactsManager_.contactWithSensor(removedContactIndex);
@@ -435,7 +459,7 @@ void LeggedOdometryManager::updateOdometryRobot(const mc_control::MCController &
 
       odometryRobot().accW(acc);
     }
-    else { mc_rtc::log::error("The acceleration must be already updated upstream."); }
+    else { MCSO_LOG_RATE_LIMITED(error, 1.0, "The acceleration must be already updated upstream."); }
   }
 
   if(updateVels)
@@ -505,47 +529,48 @@ void LeggedOdometryManager::updateFbKinematics(sva::PTransformd & pose)
 
 void LeggedOdometryManager::setNewContact(LoContactWithSensor & contact, const mc_rbdyn::Robot & measurementsRobot)
 {
-  const mc_rbdyn::ForceSensor & forceSensor = measurementsRobot.forceSensor(contact.forceSensorName());
-  // If the contact is not detected using surfaces, we must consider that the frame of the sensor is the one of the
-  // surface).
-  if(contactsManager_.getContactsDetection() == ContactsManager::ContactsDetection::fromThreshold)
+  (this->*newContactKinematicsSetter_)(contact, measurementsRobot.forceSensor(contact.forceSensorName()));
+
+  if(odometryType_ == measurements::flatOdometry)
   {
-    so::kine::Kinematics worldNewContactKineOdometryRobot;
-    so::kine::Kinematics worldContactKineRef;
-    worldContactKineRef.setZero(so::kine::Kinematics::Flags::position);
-
-    // getting the position in the world of the new contact
-    const sva::PTransformd & bodyNewContactPoseRobot = forceSensor.X_p_f();
-    so::kine::Kinematics bodyNewContactKine;
-    bodyNewContactKine.setZero(so::kine::Kinematics::Flags::pose);
-    bodyNewContactKine.position = bodyNewContactPoseRobot.translation();
-    bodyNewContactKine.orientation = so::Matrix3(bodyNewContactPoseRobot.rotation().transpose());
-
-    so::kine::Kinematics worldBodyKineOdometryRobot;
-
-    worldBodyKineOdometryRobot.position =
-        odometryRobot().mbc().bodyPosW[odometryRobot().bodyIndexByName(forceSensor.parentBody())].translation();
-    worldBodyKineOdometryRobot.orientation =
-        so::Matrix3(odometryRobot()
-                        .mbc()
-                        .bodyPosW[odometryRobot().bodyIndexByName(forceSensor.parentBody())]
-                        .rotation()
-                        .transpose());
-
-    worldNewContactKineOdometryRobot = worldBodyKineOdometryRobot * bodyNewContactKine;
-
-    contact.worldRefKine_.position = worldNewContactKineOdometryRobot.position();
-    contact.worldRefKine_.orientation = worldNewContactKineOdometryRobot.orientation;
+    // the altitude of the contact is the one of the terrain, assumed flat if no heightmap is given
+    const Eigen::Vector3d & worldContactPos = contact.worldRefKine_.position();
+    contact.worldRefKine_.position()(2) =
+        heightmap_.loaded() ? heightmap_.height(worldContactPos.x(), worldContactPos.y()) : 0.0;
   }
-  else // the kinematics of the contact are directly the ones of the surface
-  {
-    sva::PTransformd worldSurfacePoseOdometryRobot = odometryRobot().surfacePose(contact.surfaceName());
+}
 
-    contact.worldRefKine_.position = worldSurfacePoseOdometryRobot.translation();
-    contact.worldRefKine_.orientation = so::Matrix3(worldSurfacePoseOdometryRobot.rotation().transpose());
-  }
+void LeggedOdometryManager::setNewContactFromSensor(LoContactWithSensor & contact, const mc_rbdyn::ForceSensor & fs)
+{
+  so::kine::Kinematics worldNewContactKineOdometryRobot;
+
+  // getting the position in the world of the new contact
+  const sva::PTransformd & bodyNewContactPoseRobot = fs.X_p_f();
+  so::kine::Kinematics bodyNewContactKine;
+  bodyNewContactKine.setZero(so::kine::Kinematics::Flags::pose);
+  bodyNewContactKine.position = bodyNewContactPoseRobot.translation();
+  bodyNewContactKine.orientation = so::Matrix3(bodyNewContactPoseRobot.rotation().transpose());
 
-  if(odometryType_ == measurements::flatOdometry) { contact.worldRefKine_.position()(2) = 0.0; }
+  so::kine::Kinematics worldBodyKineOdometryRobot;
+
+  const sva::PTransformd & worldBodyPoseOdometryRobot =
+      odometryRobot().mbc().bodyPosW[odometryRobot().bodyIndexByName(fs.parentBody())];
+  worldBodyKineOdometryRobot.position = worldBodyPoseOdometryRobot.translation();
+  worldBodyKineOdometryRobot.orientation = so::Matrix3(worldBodyPoseOdometryRobot.rotation().transpose());
+
+  worldNewContactKineOdometryRobot = worldBodyKineOdometryRobot * bodyNewContactKine;
+
+  contact.worldRefKine_.position = worldNewContactKineOdometryRobot.position();
+  contact.worldRefKine_.orientation = worldNewContactKineOdometryRobot.orientation;
+}
+
+void LeggedOdometryManager::setNewContactFromSurface(LoContactWithSensor & contact, const mc_rbdyn::ForceSensor &)
+{
+  // the kinematics of the contact are directly the ones of the surface
+  sva::PTransformd worldSurfacePoseOdometryRobot = odometryRobot().surfacePose(contact.surfaceName());
+
+  contact.worldRefKine_.position = worldSurfacePoseOdometryRobot.translation();
+  contact.worldRefKine_.orientation = so::Matrix3(worldSurfacePoseOdometryRobot.rotation().transpose());
 }
 
 const so::kine::Kinematics & LeggedOdometryManager::getCurrentContactKinematics(LoContactWithSensor & contact,
@@ -563,27 +588,34 @@ const so::kine::Kinematics & LeggedOdometryManager::getCurrentContactKinematics(
 
   so::kine::Kinematics worldSensorKineOdometryRobot = worldBodyKineOdometryRobot * bodyContactSensorKine;
 
-  if(contactsManager_.getContactsDetection() == ContactsManager::ContactsDetection::fromThreshold)
-  {
-    // If the contact is detecting using thresholds, we will then consider the sensor frame as
-    // the contact surface frame directly.
-    contact.currentWorldKine_ = worldSensorKineOdometryRobot;
-  }
-  else // the kinematics of the contact are the ones of the associated surface
-  {
-    // the kinematics of the contacts are the ones of the surface, but we must transport the measured wrench
-    sva::PTransformd worldSurfacePoseOdometryRobot = odometryRobot().surfacePose(contact.surfaceName());
-    contact.currentWorldKine_ =
-        kinematicsTools::poseFromSva(worldSurfacePoseOdometryRobot, so::kine::Kinematics::Flags::pose);
-
-    so::kine::Kinematics contactSensorKine = contact.currentWorldKine_.getInverse() * worldSensorKineOdometryRobot;
-    // expressing the force measurement in the frame of the surface
-    contact.forceNorm_ = (contactSensorKine.orientation * fs.wrenchWithoutGravity(odometryRobot()).force()).norm();
-  }
+  (this->*currentContactKinematicsGetter_)(contact, fs, worldSensorKineOdometryRobot);
 
   return contact.currentWorldKine_;
 }
 
+void LeggedOdometryManager::currentContactKinematicsFromSensor(LoContactWithSensor & contact,
+                                                               const mc_rbdyn::ForceSensor &,
+                                                               const so::kine::Kinematics & worldSensorKine)
+{
+  // If the contact is detecting using thresholds, we will then consider the sensor frame as
+  // the contact surface frame directly.
+  contact.currentWorldKine_ = worldSensorKine;
+}
+
+void LeggedOdometryManager::currentContactKinematicsFromSurface(LoContactWithSensor & contact,
+                                                                const mc_rbdyn::ForceSensor & fs,
+                                                                const so::kine::Kinematics & worldSensorKine)
+{
+  // the kinematics of the contacts are the ones of the surface, but we must transport the measured wrench
+  sva::PTransformd worldSurfacePoseOdometryRobot = odometryRobot().surfacePose(contact.surfaceName());
+  contact.currentWorldKine_ =
+      kinematicsTools::poseFromSva(worldSurfacePoseOdometryRobot, so::kine::Kinematics::Flags::pose);
+
+  so::kine::Kinematics contactSensorKine = contact.currentWorldKine_.getInverse() * worldSensorKine;
+  // expressing the force measurement in the frame of the surface
+  contact.forceNorm_ = (contactSensorKine.orientation * fs.wrenchWithoutGravity(odometryRobot()).force()).norm();
+}
+
 void LeggedOdometryManager::selectForOrientationOdometry()
 {
   contactsManager_.oriOdometryContacts_.clear();
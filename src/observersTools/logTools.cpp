@@ -0,0 +1,48 @@
+#include <mc_state_observation/observersTools/logTools.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace mc_state_observation
+{
+namespace logTools
+{
+
+namespace
+{
+std::atomic<uint64_t> suppressedCount{0};
+
+// number of observers logging the suppressed messages with each logger
+std::mutex loggersMutex;
+std::map<const mc_rtc::Logger *, size_t> loggersUsers;
+} // namespace
+
+uint64_t suppressedMessages() noexcept
+{
+  return suppressedCount.load(std::memory_order_relaxed);
+}
+
+void addSuppressedMessage() noexcept
+{
+  suppressedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void addToLogger(mc_rtc::Logger & logger)
+{
+  std::lock_guard<std::mutex> lock(loggersMutex);
+  if(loggersUsers[&logger]++ > 0) { return; }
+  logger.addLogEntry(suppressedLogsEntry, []() -> double { return static_cast<double>(suppressedMessages()); });
+}
+
+void removeFromLogger(mc_rtc::Logger & logger)
+{
+  std::lock_guard<std::mutex> lock(loggersMutex);
+  auto users = loggersUsers.find(&logger);
+  if(users == loggersUsers.end() || --users->second > 0) { return; }
+  loggersUsers.erase(users);
+  logger.removeLogEntry(suppressedLogsEntry);
+}
+
+} // namespace logTools
+} // namespace mc_state_observation
@@ -0,0 +1,102 @@
+#include <mc_rtc/gui/Button.h>
+#include <mc_rtc/gui/Label.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/memoryTools.h>
+
+#include <stdexcept>
+
+namespace mc_state_observation
+{
+namespace memoryTools
+{
+
+size_t bytes(const mc_rbdyn::Robot & robot)
+{
+  const auto & mb = robot.mb();
+  const auto & mbc = robot.mbc();
+
+  size_t res = sizeof(mc_rbdyn::Robot);
+
+  // multibody: bodies, joints and the tree linking them
+  res += bytes(mb.bodies()) + bytes(mb.joints()) + bytes(mb.transforms());
+  res += bytes(mb.predecessors()) + bytes(mb.successors()) + bytes(mb.parents());
+  res += bytes(mb.jointsPosInParam()) + bytes(mb.jointsPosInDof());
+
+  // configuration: joints parameters and kinematics of the bodies
+  res += bytes(mbc.q) + bytes(mbc.alpha) + bytes(mbc.alphaD) + bytes(mbc.jointTorque);
+  res += bytes(mbc.jointConfig) + bytes(mbc.jointVelocity) + bytes(mbc.parentToSon) + bytes(mbc.force);
+  res += bytes(mbc.bodyPosW) + bytes(mbc.bodyVelW) + bytes(mbc.bodyVelB) + bytes(mbc.bodyAccB);
+  res += bytes(mbc.motionSubspace);
+  for(const auto & subspace : mbc.motionSubspace) { res += bytes(subspace); }
+
+  res += bytes(robot.forceSensors()) + bytes(robot.bodySensors());
+  return res;
+}
+
+size_t bytes(const mc_rbdyn::Robots & robots)
+{
+  size_t res = sizeof(mc_rbdyn::Robots);
+  for(size_t i = 0; i < robots.size(); i++) { res += bytes(robots.robot(i)); }
+  return res;
+}
+
+void MemoryReport::add(const std::string & component, Estimator estimator)
+{
+  for(const auto & c : components_)
+  {
+    if(c.name == component)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("The memory component {} is already declared", component);
+    }
+  }
+  components_.push_back({component, std::move(estimator), 0});
+}
+
+void MemoryReport::clear()
+{
+  components_.clear();
+  total_ = 0;
+}
+
+void MemoryReport::refresh()
+{
+  total_ = 0;
+  for(auto & component : components_)
+  {
+    component.bytes = component.estimator();
+    total_ += component.bytes;
+  }
+}
+
+void MemoryReport::addToLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  for(size_t i = 0; i < components_.size(); i++)
+  {
+    logger.addLogEntry(category + "_memory_" + components_[i].name,
+                       [this, i]() -> double { return static_cast<double>(components_[i].bytes); });
+  }
+  logger.addLogEntry(category + "_memory_total", [this]() -> double { return static_cast<double>(total_); });
+}
+
+void MemoryReport::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  for(const auto & component : components_) { logger.removeLogEntry(category + "_memory_" + component.name); }
+  logger.removeLogEntry(category + "_memory_total");
+}
+
+void MemoryReport::addToGUI(mc_rtc::gui::StateBuilder & gui,
+                            std::vector<std::string> category,
+                            std::function<void()> refresh)
+{
+  category.push_back("Memory");
+  gui.addElement(category, mc_rtc::gui::Button("Refresh", std::move(refresh)));
+  for(size_t i = 0; i < components_.size(); i++)
+  {
+    gui.addElement(category, mc_rtc::gui::Label(components_[i].name + " [kB]",
+                                                [this, i]() { return std::to_string(components_[i].bytes / 1024); }));
+  }
+  gui.addElement(category, mc_rtc::gui::Label("total [kB]", [this]() { return std::to_string(total_ / 1024); }));
+}
+
+} // namespace memoryTools
+} // namespace mc_state_observation
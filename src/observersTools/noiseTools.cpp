@@ -0,0 +1,38 @@
+#include <mc_rbdyn/rpy_utils.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/noiseTools.h>
+
+namespace mc_state_observation
+{
+namespace noiseTools
+{
+
+void NoiseEngine::configure(const mc_rtc::Configuration & config, const std::string & owner)
+{
+  // read as a 64 bits integer, so the logged random seeds can be given back as is
+  if(config.has("seed")) { seed(config("seed").operator uint64_t()); }
+  else
+  {
+    std::random_device rd;
+    seed((static_cast<uint64_t>(rd()) << 32) | rd());
+  }
+  mc_rtc::log::info("[{}] Noise engine seeded with {}", owner, seed_);
+}
+
+void NoiseEngine::seed(uint64_t seed)
+{
+  seed_ = seed;
+  engine_.seed(seed);
+  unit_.reset();
+}
+
+sva::PTransformd NoiseEngine::applyPoseNoise(const sva::PTransformd & X, const Vector6 & lower, const Vector6 & upper)
+{
+  const Vector6 noise = uniform(lower, upper);
+  const Eigen::Matrix3d noiseR = mc_rbdyn::rpyToMat(noise(0), noise(1), noise(2));
+
+  return sva::PTransformd((X.rotation() * noiseR).eval(), X.translation() + noise.tail<3>());
+}
+
+} // namespace noiseTools
+} // namespace mc_state_observation
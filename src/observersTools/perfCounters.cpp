@@ -0,0 +1,195 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/perfCounters.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace mc_state_observation
+{
+namespace perfCounters
+{
+
+namespace
+{
+
+#ifdef __linux__
+/// Returns the type and config of the perf event with the given name. Returns false if the name is unknown.
+bool eventAttributes(const std::string & name, uint32_t & type, uint64_t & config)
+{
+  if(name == "cycles")
+  {
+    type = PERF_TYPE_HARDWARE;
+    config = PERF_COUNT_HW_CPU_CYCLES;
+  }
+  else if(name == "instructions")
+  {
+    type = PERF_TYPE_HARDWARE;
+    config = PERF_COUNT_HW_INSTRUCTIONS;
+  }
+  else if(name == "branchMisses")
+  {
+    type = PERF_TYPE_HARDWARE;
+    config = PERF_COUNT_HW_BRANCH_MISSES;
+  }
+  else if(name == "llcMisses")
+  {
+    type = PERF_TYPE_HARDWARE;
+    config = PERF_COUNT_HW_CACHE_MISSES;
+  }
+  else if(name == "l1dMisses")
+  {
+    type = PERF_TYPE_HW_CACHE;
+    config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+  else { return false; }
+  return true;
+}
+
+int openEvent(uint32_t type, uint64_t config, int groupFd)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  // the group is started by its leader
+  attr.disabled = groupFd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // calling thread, on any CPU
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+} // namespace
+
+PerfCounters::~PerfCounters()
+{
+  close();
+}
+
+void PerfCounters::configure(const mc_rtc::Configuration & config, const std::string & owner)
+{
+  close();
+
+  bool enabled = false;
+  config("enabled", enabled);
+  if(!enabled) { return; }
+
+  std::vector<std::string> events = {"cycles", "instructions", "l1dMisses", "llcMisses", "branchMisses"};
+  config("events", events);
+
+#ifdef __linux__
+  for(const auto & event : events)
+  {
+    uint32_t type;
+    uint64_t eventConfig;
+    if(!eventAttributes(event, type, eventConfig))
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "[{}] Unknown performance counter {}. Available: cycles, instructions, l1dMisses, llcMisses, branchMisses",
+          owner, event);
+    }
+    int fd = openEvent(type, eventConfig, leaderFd_);
+    if(fd == -1)
+    {
+      mc_rtc::log::warning("[{}] The performance counter {} could not be opened: {}", owner, event,
+                           std::strerror(errno));
+      continue;
+    }
+    if(leaderFd_ == -1) { leaderFd_ = fd; }
+    fds_.push_back(fd);
+    names_.push_back(event);
+  }
+
+  if(leaderFd_ == -1)
+  {
+    mc_rtc::log::warning("[{}] No performance counter could be opened, the measurements are disabled", owner);
+    return;
+  }
+
+  // number of values, then the values in the order of the group
+  readBuffer_.resize(names_.size() + 1);
+  startValues_.resize(names_.size());
+  stopValues_.resize(names_.size());
+  last_.assign(names_.size(), 0.0);
+  total_.assign(names_.size(), 0.0);
+  iterations_ = 0;
+
+  ioctl(leaderFd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leaderFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  enabled_ = true;
+
+  std::string measured;
+  for(const auto & name : names_) { measured += (measured.empty() ? "" : ", ") + name; }
+  mc_rtc::log::info("[{}] Measuring the performance counters: {}", owner, measured);
+#else
+  mc_rtc::log::warning("[{}] The performance counters are only available on Linux, the measurements are disabled",
+                       owner);
+#endif
+}
+
+void PerfCounters::read(std::vector<uint64_t> & values)
+{
+#ifdef __linux__
+  const auto size = static_cast<ssize_t>(readBuffer_.size() * sizeof(uint64_t));
+  if(::read(leaderFd_, readBuffer_.data(), static_cast<size_t>(size)) != size) { return; }
+  for(size_t i = 0; i < values.size(); i++) { values[i] = readBuffer_[i + 1]; }
+#else
+  (void)values;
+#endif
+}
+
+void PerfCounters::accumulate()
+{
+  read(stopValues_);
+  for(size_t i = 0; i < last_.size(); i++)
+  {
+    last_[i] = static_cast<double>(stopValues_[i] - startValues_[i]);
+    total_[i] += last_[i];
+  }
+  ++iterations_;
+}
+
+void PerfCounters::close()
+{
+#ifdef __linux__
+  // the members of the group are closed before the leader
+  for(auto it = fds_.rbegin(); it != fds_.rend(); ++it) { ::close(*it); }
+#endif
+  fds_.clear();
+  names_.clear();
+  leaderFd_ = -1;
+  enabled_ = false;
+}
+
+void PerfCounters::addToLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  for(size_t i = 0; i < names_.size(); i++)
+  {
+    logger.addLogEntry(category + "_perf_" + names_[i], [this, i]() -> double { return last_[i]; });
+    logger.addLogEntry(category + "_perf_" + names_[i] + "_mean", [this, i]() -> double
+                       { return iterations_ > 0 ? total_[i] / static_cast<double>(iterations_) : 0.0; });
+  }
+}
+
+void PerfCounters::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  for(const auto & name : names_)
+  {
+    logger.removeLogEntry(category + "_perf_" + name);
+    logger.removeLogEntry(category + "_perf_" + name + "_mean");
+  }
+}
+
+} // namespace perfCounters
+} // namespace mc_state_observation
@@ -0,0 +1,151 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/standstillTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mc_state_observation
+{
+namespace standstillTools
+{
+
+namespace
+{
+
+constexpr const char * signalNames[] = {"gyrometer", "accelerometer", "encoders", "force", "torque"};
+
+} // namespace
+
+double StandstillDetector::MovingVariance::add(const Eigen::Ref<const Eigen::VectorXd> & sample, double alpha)
+{
+  if(mean.size() != sample.size())
+  {
+    // first sample, or the number of components changed
+    mean = sample;
+    variance = Eigen::VectorXd::Zero(sample.size());
+    return 0.0;
+  }
+  if(sample.size() == 0) { return 0.0; }
+
+  const Eigen::VectorXd diff = sample - mean;
+  mean += alpha * diff;
+  variance = (1.0 - alpha) * (variance + alpha * diff.cwiseAbs2());
+  return diff.cwiseAbs().maxCoeff();
+}
+
+void StandstillDetector::configure(const mc_rtc::Configuration & config, const std::string & owner, double dt)
+{
+  owner_ = owner;
+  enabled_ = config("enabled", true);
+
+  double window = 0.2;
+  double confirmationDuration = 0.5;
+  config("window", window);
+  config("confirmationDuration", confirmationDuration);
+  config("correctionPeriod", correctionPeriod_);
+  config("deviationFactor", deviationFactor_);
+  if(window < dt || correctionPeriod_ < 1)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] The standstill window must be longer than the time step and the correction period must be positive",
+        owner);
+  }
+  alpha_ = dt / window;
+  confirmationIters_ = static_cast<int>(std::ceil(confirmationDuration / dt));
+
+  if(config.has("thresholds"))
+  {
+    auto thresholdsConfig = config("thresholds");
+    for(size_t i = 0; i < nbSignals; i++) { thresholdsConfig(signalNames[i], thresholds_[i]); }
+  }
+
+  reset();
+}
+
+void StandstillDetector::reset()
+{
+  for(auto & signal : signals_)
+  {
+    signal.mean.resize(0);
+    signal.variance.resize(0);
+  }
+  stdDevs_.fill(0.0);
+  stillIters_ = 0;
+  standstill_ = false;
+  skippedIters_ = 0;
+}
+
+void StandstillDetector::update(const mc_rbdyn::Robot & robot)
+{
+  if(!enabled_) { return; }
+
+  const auto & bodySensors = robot.bodySensors();
+  const auto & forceSensors = robot.forceSensors();
+  const auto & encoderValues = robot.encoderValues();
+
+  samples_[gyrometer].resize(3 * static_cast<Eigen::Index>(bodySensors.size()));
+  samples_[accelerometer].resize(3 * static_cast<Eigen::Index>(bodySensors.size()));
+  for(size_t i = 0; i < bodySensors.size(); i++)
+  {
+    samples_[gyrometer].segment<3>(3 * static_cast<Eigen::Index>(i)) = bodySensors[i].angularVelocity();
+    samples_[accelerometer].segment<3>(3 * static_cast<Eigen::Index>(i)) = bodySensors[i].linearAcceleration();
+  }
+  samples_[encoders] = Eigen::Map<const Eigen::VectorXd>(encoderValues.data(),
+                                                         static_cast<Eigen::Index>(encoderValues.size()));
+  samples_[force].resize(3 * static_cast<Eigen::Index>(forceSensors.size()));
+  samples_[torque].resize(3 * static_cast<Eigen::Index>(forceSensors.size()));
+  for(size_t i = 0; i < forceSensors.size(); i++)
+  {
+    samples_[force].segment<3>(3 * static_cast<Eigen::Index>(i)) = forceSensors[i].wrench().force();
+    samples_[torque].segment<3>(3 * static_cast<Eigen::Index>(i)) = forceSensors[i].wrench().couple();
+  }
+
+  bool moving = false;
+  for(size_t i = 0; i < nbSignals; i++)
+  {
+    const double deviation = signals_[i].add(samples_[i], alpha_);
+    const auto & variance = signals_[i].variance;
+    stdDevs_[i] = variance.size() > 0 ? std::sqrt(variance.maxCoeff()) : 0.0;
+    // a single large deviation (impact, new contact) leaves the standstill without waiting for the variance
+    moving = moving || stdDevs_[i] > thresholds_[i] || deviation > deviationFactor_ * thresholds_[i];
+  }
+
+  if(moving)
+  {
+    stillIters_ = 0;
+    standstill_ = false;
+    skippedIters_ = 0;
+    return;
+  }
+  stillIters_ = std::min(stillIters_ + 1, confirmationIters_);
+  standstill_ = stillIters_ >= confirmationIters_;
+}
+
+bool StandstillDetector::throttle()
+{
+  if(!standstill_) { return false; }
+  if(++skippedIters_ < correctionPeriod_) { return true; }
+  skippedIters_ = 0;
+  return false;
+}
+
+void StandstillDetector::addToLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  if(!enabled_) { return; }
+  logger.addLogEntry(category + "_standstill", [this]() -> bool { return standstill_; });
+  for(size_t i = 0; i < nbSignals; i++)
+  {
+    logger.addLogEntry(category + "_standstill_stdDev_" + signalNames[i],
+                       [this, i]() -> double { return stdDevs_[i]; });
+  }
+}
+
+void StandstillDetector::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  logger.removeLogEntry(category + "_standstill");
+  for(size_t i = 0; i < nbSignals; i++) { logger.removeLogEntry(category + "_standstill_stdDev_" + signalNames[i]); }
+}
+
+} // namespace standstillTools
+} // namespace mc_state_observation
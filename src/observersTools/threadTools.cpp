@@ -0,0 +1,167 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/threadTools.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#  include <fstream>
+#  include <pthread.h>
+#  include <sched.h>
+#  include <unistd.h>
+#endif
+
+namespace mc_state_observation
+{
+namespace threadTools
+{
+
+void ThreadConfiguration::load(const mc_rtc::Configuration & config)
+{
+  config("name", name_);
+  config("cpus", cpus_);
+  config("policy", policy_);
+  config("priority", priority_);
+
+  if(policy_ != "other" && policy_ != "batch" && policy_ != "idle" && policy_ != "fifo" && policy_ != "rr")
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "Scheduling policy {} not allowed. Please pick among : [other, batch, idle, fifo, rr]", policy_);
+  }
+}
+
+#ifdef __linux__
+
+namespace
+{
+
+int policyFromName(const std::string & policy)
+{
+  if(policy == "batch") { return SCHED_BATCH; }
+  if(policy == "idle") { return SCHED_IDLE; }
+  if(policy == "fifo") { return SCHED_FIFO; }
+  if(policy == "rr") { return SCHED_RR; }
+  return SCHED_OTHER;
+}
+
+const char * policyName(int policy)
+{
+  switch(policy)
+  {
+    case SCHED_BATCH:
+      return "batch";
+    case SCHED_IDLE:
+      return "idle";
+    case SCHED_FIFO:
+      return "fifo";
+    case SCHED_RR:
+      return "rr";
+    default:
+      return "other";
+  }
+}
+
+/// Indicates if the CPU exists and is online. The CPUs that can't be taken offline (usually the CPU 0) have no online
+/// attribute.
+bool cpuAvailable(unsigned int cpu)
+{
+  const long nbCpus = sysconf(_SC_NPROCESSORS_CONF);
+  if(cpu >= CPU_SETSIZE || (nbCpus > 0 && cpu >= static_cast<unsigned long>(nbCpus))) { return false; }
+  std::ifstream online("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/online");
+  char state = '1';
+  return !(online >> state) || state == '1';
+}
+
+} // namespace
+
+bool applyToCurrentThread(const ThreadConfiguration & config, const std::string & owner)
+{
+  const pthread_t thread = pthread_self();
+  bool success = true;
+
+  if(!config.name_.empty())
+  {
+    // the name of a thread is limited to 15 characters
+    const std::string name = config.name_.substr(0, 15);
+    int err = pthread_setname_np(thread, name.c_str());
+    if(err != 0)
+    {
+      mc_rtc::log::warning("[{}] Could not name the thread {}: {}", owner, name, std::strerror(err));
+      success = false;
+    }
+  }
+
+  if(!config.cpus_.empty())
+  {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for(const auto & cpu : config.cpus_)
+    {
+      if(cpuAvailable(cpu)) { CPU_SET(cpu, &cpus); }
+      else
+      {
+        mc_rtc::log::error("[{}] The CPU {} of the thread {} doesn't exist or is offline", owner, cpu, config.name_);
+        success = false;
+      }
+    }
+    // the affinity is kept if none of the CPUs is available
+    int err = CPU_COUNT(&cpus) > 0 ? pthread_setaffinity_np(thread, sizeof(cpus), &cpus) : EINVAL;
+    if(err != 0)
+    {
+      mc_rtc::log::warning("[{}] Could not set the affinity of the thread {}: {}", owner, config.name_,
+                           std::strerror(err));
+      success = false;
+    }
+  }
+
+  sched_param param{};
+  const int policy = policyFromName(config.policy_);
+  if(policy == SCHED_FIFO || policy == SCHED_RR) { param.sched_priority = config.priority_; }
+  int err = pthread_setschedparam(thread, policy, &param);
+  if(err != 0)
+  {
+    mc_rtc::log::warning("[{}] Could not set the scheduling policy {} (priority {}) of the thread {}: {}", owner,
+                         config.policy_, config.priority_, config.name_, std::strerror(err));
+    success = false;
+  }
+
+  /* The effective settings are read back from the system */
+  char effectiveName[16] = "";
+  pthread_getname_np(thread, effectiveName, sizeof(effectiveName));
+
+  std::string effectiveCpus;
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if(pthread_getaffinity_np(thread, sizeof(cpus), &cpus) == 0)
+  {
+    for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+      if(!CPU_ISSET(cpu, &cpus)) { continue; }
+      if(!effectiveCpus.empty()) { effectiveCpus += ", "; }
+      effectiveCpus += std::to_string(cpu);
+    }
+  }
+
+  int effectivePolicy = SCHED_OTHER;
+  sched_param effectiveParam{};
+  pthread_getschedparam(thread, &effectivePolicy, &effectiveParam);
+
+  mc_rtc::log::info("[{}] Thread {} started (cpus: [{}], policy: {}, priority: {})", owner, effectiveName,
+                    effectiveCpus, policyName(effectivePolicy), effectiveParam.sched_priority);
+
+  return success;
+}
+
+#else
+
+bool applyToCurrentThread(const ThreadConfiguration & config, const std::string & owner)
+{
+  mc_rtc::log::warning("[{}] The placement and scheduling of the thread {} are only supported on Linux", owner,
+                       config.name_);
+  return false;
+}
+
+#endif
+
+} // namespace threadTools
+} // namespace mc_state_observation
@@ -0,0 +1,311 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/traceTools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#  include <pthread.h>
+#endif
+
+namespace mc_state_observation
+{
+namespace traceTools
+{
+
+namespace
+{
+
+struct Event
+{
+  const char * name;
+  uint64_t begin;
+  uint64_t end;
+};
+
+/// Ring buffer of the events of a thread. Only written by the thread that claimed it, read by the writer thread while
+/// the recording is paused.
+struct ThreadBuffer
+{
+  uint32_t tid = 0;
+  char name[16] = "";
+  std::vector<Event> events;
+  // index of the slot in which the next event is written
+  size_t head = 0;
+  // number of valid events
+  size_t count = 0;
+};
+
+class Tracer
+{
+public:
+  static Tracer & get()
+  {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  ~Tracer() { disable(); }
+
+  void startSession(const std::string & owner,
+                    const std::string & directory,
+                    size_t eventsPerThread,
+                    size_t maxThreads,
+                    const threadTools::ThreadConfiguration & threadConfig)
+  {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    if(sessions_++ > 0)
+    {
+      if(directory != directory_ || std::max<size_t>(eventsPerThread, 1) != pool_.front().events.size()
+         || std::max<size_t>(maxThreads, 1) != pool_.size())
+      {
+        mc_rtc::log::warning("[{}] The tracing is already enabled, the settings of the first session are kept ({} "
+                             "events for {} threads, traces written in {})",
+                             owner, pool_.front().events.size(), pool_.size(), directory_);
+      }
+      return;
+    }
+
+    directory_ = directory;
+    // the buffers are allocated here, the threads only claim one at their first event
+    pool_.resize(std::max<size_t>(maxThreads, 1));
+    for(auto & buffer : pool_) { buffer.events.resize(std::max<size_t>(eventsPerThread, 1)); }
+    claimed_.store(0, std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    stop_ = false;
+    thread_ = threadTools::startThread(threadConfig, "traceTools", [this]() { dumpLoop(); });
+    enabled_.store(true, std::memory_order_seq_cst);
+    mc_rtc::log::info("[{}] Tracing enabled ({} events for {} threads), traces written in {}", owner,
+                      pool_.front().events.size(), pool_.size(), directory_);
+  }
+
+  void stopSession()
+  {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    if(sessions_ == 0 || --sessions_ > 0) { return; }
+    disable();
+    mc_rtc::log::info("[traceTools] Tracing disabled");
+  }
+
+  inline bool enabled() const noexcept { return enabled_.load(std::memory_order_acquire); }
+
+  bool requestDump(const char * reason)
+  {
+    if(!enabled()) { return false; }
+    bool expected = false;
+    // a dump is already ongoing
+    if(!paused_.compare_exchange_strong(expected, true, std::memory_order_seq_cst)) { return false; }
+    reason_.store(reason, std::memory_order_release);
+    cv_.notify_one();
+    return true;
+  }
+
+  void record(const char * name, uint64_t begin, uint64_t end) noexcept
+  {
+    // the buffers are neither read by the writer thread nor released while an event is written
+    writers_.fetch_add(1, std::memory_order_seq_cst);
+    if(enabled_.load(std::memory_order_seq_cst) && !paused_.load(std::memory_order_seq_cst))
+    {
+      ThreadBuffer * buffer = localBuffer();
+      if(buffer != nullptr)
+      {
+        buffer->events[buffer->head] = {name, begin, end};
+        buffer->head = (buffer->head + 1) % buffer->events.size();
+        if(buffer->count < buffer->events.size()) { ++buffer->count; }
+      }
+    }
+    writers_.fetch_sub(1, std::memory_order_release);
+  }
+
+private:
+  /// Returns the buffer claimed by the calling thread since the tracing was enabled, claims one at its first event.
+  /// Returns nullptr if all the buffers are claimed by other threads.
+  ThreadBuffer * localBuffer() noexcept
+  {
+    struct LocalBuffer
+    {
+      ThreadBuffer * buffer = nullptr;
+      // enabling of the tracing in which the buffer was claimed
+      uint64_t generation = 0;
+    };
+    thread_local LocalBuffer local;
+
+    const uint64_t generation = generation_.load(std::memory_order_relaxed);
+    if(local.generation == generation) { return local.buffer; }
+
+    local.generation = generation;
+    local.buffer = nullptr;
+    const size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+    if(index >= pool_.size()) { return nullptr; }
+
+    ThreadBuffer & buffer = pool_[index];
+    buffer.tid = static_cast<uint32_t>(index + 1);
+#ifdef __linux__
+    pthread_getname_np(pthread_self(), buffer.name, sizeof(buffer.name));
+#endif
+    if(buffer.name[0] == '\0') { std::snprintf(buffer.name, sizeof(buffer.name), "thread%u", buffer.tid); }
+    local.buffer = &buffer;
+    return local.buffer;
+  }
+
+  /// Waits for the end of the events being written.
+  void waitWriters() const noexcept
+  {
+    while(writers_.load(std::memory_order_seq_cst) > 0) { std::this_thread::yield(); }
+  }
+
+  /// Stops the writer thread and releases the buffers once the events being written are complete.
+  void disable()
+  {
+    enabled_.store(false, std::memory_order_seq_cst);
+    waitWriters();
+    if(thread_.joinable())
+    {
+      stop_ = true;
+      cv_.notify_one();
+      thread_.join();
+    }
+    std::vector<ThreadBuffer>().swap(pool_);
+    reason_.store(nullptr, std::memory_order_relaxed);
+    paused_.store(false, std::memory_order_seq_cst);
+  }
+
+  void dumpLoop()
+  {
+    while(!stop_)
+    {
+      {
+        std::unique_lock<std::mutex> lock(cvMutex_);
+        // the real-time thread doesn't take the lock when notifying, the timeout avoids missing a request
+        cv_.wait_for(lock, std::chrono::milliseconds(100),
+                     [this]() { return stop_ || reason_.load(std::memory_order_acquire) != nullptr; });
+      }
+      if(reason_.load(std::memory_order_acquire) == nullptr) { continue; }
+
+      writeFile();
+
+      reason_.store(nullptr, std::memory_order_release);
+      paused_.store(false, std::memory_order_seq_cst);
+    }
+  }
+
+  void writeFile()
+  {
+    const std::time_t date = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char dateStr[32];
+    std::strftime(dateStr, sizeof(dateStr), "%Y%m%d-%H%M%S", std::localtime(&date));
+    const std::string path =
+        fmt::format("{}/mc_state_observation-trace-{}-{}.json", directory_, dateStr, reason_.load());
+
+    std::ofstream file(path);
+    if(!file)
+    {
+      mc_rtc::log::error("[traceTools] Could not open {} to dump the trace", path);
+      return;
+    }
+
+    // the buffers are only released once the writer thread is stopped. New threads can't claim one while the recording
+    // is paused.
+    waitWriters();
+    const size_t nbBuffers = std::min(claimed_.load(std::memory_order_relaxed), pool_.size());
+
+    size_t nbEvents = 0;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for(size_t b = 0; b < nbBuffers; b++)
+    {
+      const ThreadBuffer * buffer = &pool_[b];
+      file << (b == 0 ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+           << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+
+      // oldest events first: if the buffer is full, the oldest one is located at the head.
+      const size_t oldest = buffer->count < buffer->events.size() ? 0 : buffer->head;
+      for(size_t i = 0; i < buffer->count; i++)
+      {
+        const Event & event = buffer->events[(oldest + i) % buffer->events.size()];
+        file << fmt::format(",{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                            event.name, buffer->tid, static_cast<double>(event.begin) * 1e-3,
+                            static_cast<double>(event.end - event.begin) * 1e-3);
+      }
+      nbEvents += buffer->count;
+    }
+    file << "]}\n";
+
+    if(!file)
+    {
+      mc_rtc::log::error("[traceTools] Failed to write the trace to {}", path);
+      return;
+    }
+    mc_rtc::log::success("[traceTools] Trace of {} events from {} threads dumped to {}", nbEvents, nbBuffers,
+                         path);
+  }
+
+private:
+  std::atomic<bool> enabled_{false};
+  std::string directory_;
+
+  // number of started sessions, the tracing is enabled while it is positive
+  std::mutex sessionsMutex_;
+  size_t sessions_ = 0;
+
+  // buffers allocated when the tracing is enabled
+  std::vector<ThreadBuffer> pool_;
+  // number of buffers claimed by the threads (may exceed the number of buffers)
+  std::atomic<size_t> claimed_{0};
+  // incremented at each enabling, so the threads claim a new buffer
+  std::atomic<uint64_t> generation_{0};
+  // number of events being written
+  std::atomic<int> writers_{0};
+
+  // true while the writer thread reads the buffers
+  std::atomic<bool> paused_{false};
+  std::atomic<const char *> reason_{nullptr};
+  std::atomic<bool> stop_{false};
+  std::mutex cvMutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+} // namespace
+
+void Session::start(const std::string & owner,
+                    const std::string & directory,
+                    size_t eventsPerThread,
+                    size_t maxThreads,
+                    const threadTools::ThreadConfiguration & threadConfig)
+{
+  if(started_) { return; }
+  Tracer::get().startSession(owner, directory, eventsPerThread, maxThreads, threadConfig);
+  started_ = true;
+}
+
+void Session::stop()
+{
+  if(!started_) { return; }
+  Tracer::get().stopSession();
+  started_ = false;
+}
+
+bool enabled() noexcept
+{
+  return Tracer::get().enabled();
+}
+
+bool requestDump(const char * reason)
+{
+  return Tracer::get().requestDump(reason);
+}
+
+void record(const char * name, uint64_t begin, uint64_t end) noexcept
+{
+  Tracer::get().record(name, begin, end);
+}
+
+} // namespace traceTools
+} // namespace mc_state_observation
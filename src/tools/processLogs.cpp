@@ -0,0 +1,546 @@
+/**
+ * \file      processLogs.cpp
+ * \brief      Re-runs the observers over a directory of recorded mc_rtc logs.
+ *
+ * \details
+ * Usage: mcso_process_logs <logs directory> <configuration> <output directory> [nbThreads]
+ *
+ * Every (log, configuration) pair is a job. The jobs are distributed over the threads by a work-stealing scheduler:
+ * each thread owns a queue of jobs, processes it from the back and, once empty, steals the jobs at the front of the
+ * queues of the other threads, so the threads stay busy although the logs have very different durations.
+ *
+ * Each job creates its own headless controller and observers (headlessTools.h). The log is streamed iteration by
+ * iteration (it is never loaded fully): the measurements are gathered in chunks of contiguous iterations which are
+ * processed by the batch loop (batchTools.h), and the estimation of each chunk is appended to the output of the job.
+ *
+ * Configuration:
+ *    robot: [JVRC1]          # robot module, as given to mc_rtc's RobotLoader
+ *    dt: 0.005
+ *    chunkSize: 2000         # number of iterations processed together
+ *    threads: {policy: batch}  # placement and scheduling of the worker threads (see threadTools.h)
+ *    keys:                   # log entries containing the measurements
+ *      encoders: qIn
+ *      encoderVelocities: alphaIn  # optional
+ *      gyrometerSuffix: _angularVelocity      # appended to the name of each body sensor
+ *      accelerometerSuffix: _linearAcceleration
+ *      wrenchSuffix: ""      # appended to the name of each force sensor
+ *    configurations:
+ *      - name: default
+ *        # observers run in this order at each iteration, the estimation is the one of the last observer
+ *        observers:
+ *          - type: TiltObserver
+ *            config: {asBackup: true, ...}
+ *          - type: MCKineticsObserver
+ *            config: {...}   # without the trace entry, the execution trace is shared by the concurrent jobs
+ *
+ * Output of a job (<log>__<configuration>.bin, little endian): the magic "MCSOEST1", the number of iterations (uint64),
+ * then for each iteration 15 doubles: the time of the log, the position, the orientation quaternion (x, y, z, w), the
+ * linear and angular velocities of the floating base in the world and the duration of the iteration of the observers.
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rtc/log/iterate_binary_log.h>
+#include <mc_rtc/log/utils.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/MCKineticsObserver.h>
+#include <mc_state_observation/NaiveOdometry.h>
+#include <mc_state_observation/TiltObserver.h>
+#include <mc_state_observation/observersTools/batchTools.h>
+#include <mc_state_observation/observersTools/headlessTools.h>
+#include <mc_state_observation/observersTools/threadTools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace mcso = mc_state_observation;
+
+namespace
+{
+
+constexpr char estimationMagic[] = "MCSOEST1";
+constexpr size_t valuesPerIteration = 15;
+
+/// Configuration of the observers run by a job.
+struct ObserversConfiguration
+{
+  std::string name;
+  mc_rtc::Configuration observers;
+};
+
+/// Names of the log entries containing the measurements.
+struct LogKeys
+{
+  std::string encoders = "qIn";
+  std::string encoderVelocities = "alphaIn";
+  std::string gyrometerSuffix = "_angularVelocity";
+  std::string accelerometerSuffix = "_linearAcceleration";
+  std::string wrenchSuffix = "";
+};
+
+struct ToolConfiguration
+{
+  std::vector<std::string> robotModule;
+  double dt = 0.005;
+  Eigen::Index chunkSize = 2000;
+  mcso::threadTools::ThreadConfiguration threads{"processLogs"};
+  LogKeys keys;
+  std::vector<ObserversConfiguration> configurations;
+};
+
+struct Job
+{
+  fs::path log;
+  const ObserversConfiguration * configuration;
+};
+
+/// Queues of jobs of the threads. A thread takes its own jobs from the back and steals the ones of the other threads
+/// from the front.
+class WorkStealingQueues
+{
+public:
+  explicit WorkStealingQueues(size_t nbThreads) : queues_(nbThreads) {}
+
+  /// Distributes the jobs over the queues.
+  void push(std::vector<Job> jobs)
+  {
+    for(size_t i = 0; i < jobs.size(); i++) { queues_[i % queues_.size()].jobs.push_back(std::move(jobs[i])); }
+  }
+
+  /// Returns the next job of the given thread, stolen from another thread if its queue is empty.
+  std::optional<Job> pop(size_t thread)
+  {
+    {
+      Queue & own = queues_[thread];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if(!own.jobs.empty())
+      {
+        Job job = own.jobs.back();
+        own.jobs.pop_back();
+        return job;
+      }
+    }
+    // the jobs don't create other jobs, once all the queues are empty the thread is done
+    for(size_t i = 1; i < queues_.size(); i++)
+    {
+      Queue & victim = queues_[(thread + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if(!victim.jobs.empty())
+      {
+        Job job = victim.jobs.front();
+        victim.jobs.pop_front();
+        return job;
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+  std::vector<Queue> queues_;
+};
+
+/// Observers of a job, run in order at each iteration.
+struct ObserversPipeline
+{
+  std::vector<std::unique_ptr<mc_observers::Observer>> observers;
+  // estimation of the last observer
+  std::function<void(sva::PTransformd &, sva::MotionVecd &)> estimation;
+
+  template<typename ObserverT>
+  void add(mc_control::MCController & ctl, const std::string & type, const mc_rtc::Configuration & config)
+  {
+    auto observer = mcso::headlessTools::makeObserver<ObserverT>(ctl, type, config);
+    const ObserverT * estimator = observer.get();
+    estimation = [estimator](sva::PTransformd & X, sva::MotionVecd & v)
+    {
+      X = estimator->posW();
+      v = estimator->velW();
+    };
+    observers.push_back(std::move(observer));
+  }
+};
+
+ObserversPipeline makePipeline(mc_control::MCController & ctl, const mc_rtc::Configuration & observersConfig)
+{
+  ObserversPipeline pipeline;
+  for(const auto & observerConfig : observersConfig)
+  {
+    const std::string type = observerConfig("type");
+    const mc_rtc::Configuration config = observerConfig("config", mc_rtc::Configuration{});
+    if(type == "MCKineticsObserver") { pipeline.add<mcso::MCKineticsObserver>(ctl, type, config); }
+    else if(type == "TiltObserver") { pipeline.add<mcso::TiltObserver>(ctl, type, config); }
+    else if(type == "NaiveOdometry") { pipeline.add<mcso::NaiveOdometry>(ctl, type, config); }
+    else
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "Observer {} not allowed. Please pick among : [MCKineticsObserver, TiltObserver, NaiveOdometry]", type);
+    }
+  }
+  if(pipeline.observers.empty()) { mc_rtc::log::error_and_throw<std::runtime_error>("No observer configured"); }
+  return pipeline;
+}
+
+/// Runs the observers of a configuration over a log.
+class JobRunner
+{
+public:
+  JobRunner(const ToolConfiguration & tool, const Job & job, const fs::path & outputDirectory)
+  : tool_(tool), job_(job),
+    ctl_(mcso::headlessTools::makeController(mc_rbdyn::RobotLoader::get_robot_module(tool.robotModule), tool.dt)),
+    pipeline_(makePipeline(*ctl_, job.configuration->observers)),
+    outputPath_(outputDirectory / (job.log.stem().string() + "__" + job.configuration->name + ".bin"))
+  {
+    const auto & robot = ctl_->robot();
+    const auto nbJoints = static_cast<Eigen::Index>(robot.refJointOrder().size());
+    const auto nbBodySensors = static_cast<Eigen::Index>(robot.bodySensors().size());
+    const auto nbForceSensors = static_cast<Eigen::Index>(robot.forceSensors().size());
+    chunk_.encoders.resize(nbJoints, tool.chunkSize);
+    chunk_.gyrometers.resize(3 * nbBodySensors, tool.chunkSize);
+    chunk_.accelerometers.resize(3 * nbBodySensors, tool.chunkSize);
+    chunk_.wrenches.resize(6 * nbForceSensors, tool.chunkSize);
+    times_.resize(static_cast<size_t>(tool.chunkSize));
+    durations_.resize(static_cast<size_t>(tool.chunkSize));
+
+    for(const auto & bs : robot.bodySensors())
+    {
+      gyrometerKeys_.push_back(bs.name() + tool.keys.gyrometerSuffix);
+      accelerometerKeys_.push_back(bs.name() + tool.keys.accelerometerSuffix);
+    }
+    for(const auto & fs : robot.forceSensors()) { wrenchKeys_.push_back(fs.name() + tool.keys.wrenchSuffix); }
+
+    output_.open(outputPath_, std::ios::binary);
+    if(!output_) { mc_rtc::log::error_and_throw<std::runtime_error>("Could not open {}", outputPath_.string()); }
+    const uint64_t nbIters = 0;
+    output_.write(estimationMagic, sizeof(estimationMagic) - 1);
+    output_.write(reinterpret_cast<const char *>(&nbIters), sizeof(nbIters));
+  }
+
+  /// Streams the log and returns the number of processed iterations.
+  uint64_t run()
+  {
+    const bool read = mc_rtc::log::iterate_binary_log(
+        job_.log.string(),
+        [this](const std::vector<std::string> & keys, const std::vector<mc_rtc::log::FlatLog::record> & records,
+               double t)
+        {
+          if(keys.size() != resolvedKeysSize_) { resolveKeys(keys); }
+          readIteration(records, t);
+          if(chunkIters_ == tool_.chunkSize) { processChunk(); }
+          return true;
+        },
+        false);
+    if(!read) { mc_rtc::log::error_and_throw<std::runtime_error>("Could not read the log {}", job_.log.string()); }
+    if(chunkIters_ > 0) { processChunk(); }
+
+    // number of iterations in the header
+    output_.seekp(sizeof(estimationMagic) - 1);
+    output_.write(reinterpret_cast<const char *>(&totalIters_), sizeof(totalIters_));
+    output_.close();
+    if(!output_) { mc_rtc::log::error_and_throw<std::runtime_error>("Failed to write {}", outputPath_.string()); }
+    return totalIters_;
+  }
+
+private:
+  /// Resolves the indices of the measurements in the entries of the log, which change when entries are added or
+  /// removed.
+  void resolveKeys(const std::vector<std::string> & keys)
+  {
+    auto index = [&keys, this](const std::string & key, bool optional) -> int
+    {
+      auto it = std::find(keys.begin(), keys.end(), key);
+      if(it != keys.end()) { return static_cast<int>(it - keys.begin()); }
+      if(!optional)
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>("The log {} has no entry {}", job_.log.string(), key);
+      }
+      return -1;
+    };
+    encodersIndex_ = index(tool_.keys.encoders, false);
+    encoderVelocitiesIndex_ = tool_.keys.encoderVelocities.empty() ? -1 : index(tool_.keys.encoderVelocities, true);
+    gyrometerIndices_.clear();
+    accelerometerIndices_.clear();
+    wrenchIndices_.clear();
+    for(const auto & key : gyrometerKeys_) { gyrometerIndices_.push_back(index(key, false)); }
+    for(const auto & key : accelerometerKeys_) { accelerometerIndices_.push_back(index(key, false)); }
+    for(const auto & key : wrenchKeys_) { wrenchIndices_.push_back(index(key, false)); }
+    resolvedKeysSize_ = keys.size();
+
+    if(encoderVelocitiesIndex_ >= 0 && chunk_.encoderVelocities.size() == 0)
+    {
+      chunk_.encoderVelocities.resize(chunk_.encoders.rows(), tool_.chunkSize);
+    }
+  }
+
+  /// Returns the value of an entry of the log, after checking its type.
+  template<typename T>
+  const T & value(const std::vector<mc_rtc::log::FlatLog::record> & records, int index, const std::string & key) const
+  {
+    const auto & record = records[static_cast<size_t>(index)];
+    if(record.type != mc_rtc::log::GetLogType<T>::type)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("The entry {} of the log {} has the type {} instead of {}", key,
+                                                       job_.log.string(), static_cast<int>(record.type),
+                                                       static_cast<int>(mc_rtc::log::GetLogType<T>::type));
+    }
+    return *static_cast<const T *>(record.data.get());
+  }
+
+  /// Returns the joint values of an entry of the log, after checking that it matches the joints of the robot.
+  Eigen::Map<const Eigen::VectorXd> jointValues(const std::vector<mc_rtc::log::FlatLog::record> & records,
+                                                int index,
+                                                const std::string & key) const
+  {
+    const auto & values = value<std::vector<double>>(records, index, key);
+    if(static_cast<Eigen::Index>(values.size()) != chunk_.encoders.rows())
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("The entry {} of the log {} has {} joints, the robot has {}",
+                                                       key, job_.log.string(), values.size(), chunk_.encoders.rows());
+    }
+    return Eigen::Map<const Eigen::VectorXd>(values.data(), chunk_.encoders.rows());
+  }
+
+  void readIteration(const std::vector<mc_rtc::log::FlatLog::record> & records, double t)
+  {
+    const Eigen::Index col = chunkIters_;
+    chunk_.encoders.col(col) = jointValues(records, encodersIndex_, tool_.keys.encoders);
+    if(encoderVelocitiesIndex_ >= 0)
+    {
+      chunk_.encoderVelocities.col(col) = jointValues(records, encoderVelocitiesIndex_, tool_.keys.encoderVelocities);
+    }
+    for(size_t i = 0; i < gyrometerIndices_.size(); i++)
+    {
+      const auto row = 3 * static_cast<Eigen::Index>(i);
+      chunk_.gyrometers.block<3, 1>(row, col) =
+          value<Eigen::Vector3d>(records, gyrometerIndices_[i], gyrometerKeys_[i]);
+      chunk_.accelerometers.block<3, 1>(row, col) =
+          value<Eigen::Vector3d>(records, accelerometerIndices_[i], accelerometerKeys_[i]);
+    }
+    for(size_t i = 0; i < wrenchIndices_.size(); i++)
+    {
+      chunk_.wrenches.block<6, 1>(6 * static_cast<Eigen::Index>(i), col) =
+          value<sva::ForceVecd>(records, wrenchIndices_[i], wrenchKeys_[i]).vector();
+    }
+    times_[static_cast<size_t>(col)] = t;
+    ++chunkIters_;
+  }
+
+  /// Runs the observers on the gathered iterations and appends their estimation to the output.
+  void processChunk()
+  {
+    const Eigen::Index nbIters = chunkIters_;
+    const bool withVelocities = chunk_.encoderVelocities.size() > 0;
+    mcso::batchTools::InputView inputs(chunk_.encoders.leftCols(nbIters),
+                                       chunk_.encoderVelocities.leftCols(withVelocities ? nbIters : 0),
+                                       chunk_.gyrometers.leftCols(nbIters), chunk_.accelerometers.leftCols(nbIters),
+                                       chunk_.wrenches.leftCols(nbIters));
+    estimation_.resize(nbIters);
+    mcso::batchTools::OutputView outputs(estimation_);
+
+    size_t iter = 0;
+    mcso::batchTools::runBatch(*ctl_, ctl_->robot().name(), inputs, outputs, job_.configuration->name,
+                               [this, &iter](sva::PTransformd & X, sva::MotionVecd & v)
+                               {
+                                 const auto start = std::chrono::steady_clock::now();
+                                 for(auto & observer : pipeline_.observers) { observer->run(*ctl_); }
+                                 durations_[iter++] =
+                                     std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                                 pipeline_.estimation(X, v);
+                               });
+
+    std::vector<double> values(valuesPerIteration * static_cast<size_t>(nbIters));
+    for(Eigen::Index i = 0; i < nbIters; i++)
+    {
+      double * sample = values.data() + valuesPerIteration * static_cast<size_t>(i);
+      sample[0] = times_[static_cast<size_t>(i)];
+      Eigen::Map<Eigen::Vector3d>(sample + 1) = estimation_.positions.col(i);
+      Eigen::Map<Eigen::Vector4d>(sample + 4) = estimation_.orientations.col(i);
+      Eigen::Map<Eigen::Vector3d>(sample + 8) = estimation_.linVels.col(i);
+      Eigen::Map<Eigen::Vector3d>(sample + 11) = estimation_.angVels.col(i);
+      sample[14] = durations_[static_cast<size_t>(i)];
+    }
+    output_.write(reinterpret_cast<const char *>(values.data()),
+                  static_cast<std::streamsize>(values.size() * sizeof(double)));
+
+    totalIters_ += static_cast<uint64_t>(nbIters);
+    chunkIters_ = 0;
+  }
+
+private:
+  const ToolConfiguration & tool_;
+  const Job & job_;
+  std::unique_ptr<mc_control::MCController> ctl_;
+  ObserversPipeline pipeline_;
+
+  fs::path outputPath_;
+  std::ofstream output_;
+
+  // names of the log entries of the sensors, in the order of the robot
+  std::vector<std::string> gyrometerKeys_;
+  std::vector<std::string> accelerometerKeys_;
+  std::vector<std::string> wrenchKeys_;
+  // indices of the measurements in the entries of the log
+  size_t resolvedKeysSize_ = 0;
+  int encodersIndex_ = -1;
+  int encoderVelocitiesIndex_ = -1;
+  std::vector<int> gyrometerIndices_;
+  std::vector<int> accelerometerIndices_;
+  std::vector<int> wrenchIndices_;
+
+  // measurements of the current chunk
+  mcso::batchTools::InputSequence chunk_;
+  std::vector<double> times_;
+  std::vector<double> durations_;
+  Eigen::Index chunkIters_ = 0;
+  mcso::batchTools::OutputSequence estimation_;
+  uint64_t totalIters_ = 0;
+};
+
+ToolConfiguration loadConfiguration(const std::string & path)
+{
+  const mc_rtc::Configuration config(path);
+  ToolConfiguration tool;
+  tool.robotModule = config("robot", std::vector<std::string>{});
+  if(tool.robotModule.empty())
+  {
+    std::string robot = config("robot");
+    tool.robotModule = {robot};
+  }
+  config("dt", tool.dt);
+  int chunkSize = static_cast<int>(tool.chunkSize);
+  config("chunkSize", chunkSize);
+  tool.chunkSize = std::max(chunkSize, 1);
+  if(config.has("threads")) { tool.threads.load(config("threads")); }
+  if(config.has("keys"))
+  {
+    auto keys = config("keys");
+    keys("encoders", tool.keys.encoders);
+    keys("encoderVelocities", tool.keys.encoderVelocities);
+    keys("gyrometerSuffix", tool.keys.gyrometerSuffix);
+    keys("accelerometerSuffix", tool.keys.accelerometerSuffix);
+    keys("wrenchSuffix", tool.keys.wrenchSuffix);
+  }
+  for(const auto & configuration : config("configurations"))
+  {
+    tool.configurations.push_back({configuration("name"), configuration("observers")});
+    // the execution trace is shared by the whole process: the dumps requested by a job would pause the recording of
+    // all the others, and the deadlines of the real-time loop don't apply to the jobs
+    for(const auto & observer : tool.configurations.back().observers)
+    {
+      if(observer.has("config") && observer("config").has("trace"))
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>(
+            "The execution trace can't be enabled in the configuration {} as the jobs run concurrently",
+            tool.configurations.back().name);
+      }
+    }
+  }
+  return tool;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  if(argc < 4)
+  {
+    mc_rtc::log::error("Usage: {} <logs directory> <configuration> <output directory> [nbThreads]", argv[0]);
+    return 1;
+  }
+  const fs::path logsDirectory = argv[1];
+  const fs::path outputDirectory = argv[3];
+  size_t nbThreads = argc > 4 ? std::stoul(argv[4]) : std::thread::hardware_concurrency();
+  nbThreads = std::max<size_t>(nbThreads, 1);
+
+  ToolConfiguration tool;
+  try
+  {
+    tool = loadConfiguration(argv[2]);
+  }
+  catch(const std::exception & e)
+  {
+    mc_rtc::log::error("Invalid configuration {}: {}", argv[2], e.what());
+    return 1;
+  }
+  fs::create_directories(outputDirectory);
+
+  std::vector<fs::path> logs;
+  for(const auto & entry : fs::directory_iterator(logsDirectory))
+  {
+    if(entry.is_regular_file() && entry.path().extension() == ".bin") { logs.push_back(entry.path()); }
+  }
+  // largest logs first, so the long jobs are not the last ones to start
+  std::sort(logs.begin(), logs.end(),
+            [](const fs::path & a, const fs::path & b) { return fs::file_size(a) > fs::file_size(b); });
+
+  std::vector<Job> jobs;
+  for(const auto & log : logs)
+  {
+    for(const auto & configuration : tool.configurations) { jobs.push_back({log, &configuration}); }
+  }
+  mc_rtc::log::info("Processing {} logs with {} configurations ({} jobs) on {} threads", logs.size(),
+                    tool.configurations.size(), jobs.size(), nbThreads);
+
+  WorkStealingQueues queues(nbThreads);
+  // the queues are filled in reverse so each thread starts with the largest of its jobs
+  std::reverse(jobs.begin(), jobs.end());
+  queues.push(std::move(jobs));
+
+  std::atomic<size_t> failures{0};
+  std::mutex logMutex;
+  const auto start = std::chrono::steady_clock::now();
+  auto worker = [&](size_t thread)
+  {
+    while(auto job = queues.pop(thread))
+    {
+      const auto jobStart = std::chrono::steady_clock::now();
+      try
+      {
+        JobRunner runner(tool, *job, outputDirectory);
+        const uint64_t nbIters = runner.run();
+        const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - jobStart).count();
+        std::lock_guard<std::mutex> lock(logMutex);
+        mc_rtc::log::success("{} / {}: {} iterations in {:.1f} s ({:.1f} us per iteration)",
+                             job->log.filename().string(), job->configuration->name, nbIters, duration,
+                             nbIters > 0 ? duration / static_cast<double>(nbIters) * 1e6 : 0.0);
+      }
+      catch(const std::exception & e)
+      {
+        ++failures;
+        std::lock_guard<std::mutex> lock(logMutex);
+        mc_rtc::log::error("{} / {} failed: {}", job->log.filename().string(), job->configuration->name, e.what());
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(size_t i = 1; i < nbThreads; i++)
+  {
+    mcso::threadTools::ThreadConfiguration threadConfig = tool.threads;
+    threadConfig.name_ += std::to_string(i);
+    threads.push_back(mcso::threadTools::startThread(threadConfig, "processLogs", [&worker, i]() { worker(i); }));
+  }
+  mcso::threadTools::applyToCurrentThread(tool.threads, "processLogs");
+  worker(0);
+  for(auto & thread : threads) { thread.join(); }
+
+  mc_rtc::log::info("Processed the archive in {:.1f} s, {} failed jobs",
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), failures.load());
+  return failures > 0 ? 1 : 0;
+}
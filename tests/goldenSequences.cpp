@@ -0,0 +1,497 @@
+/**
+ * \file      goldenSequences.cpp
+ * \brief      Regression test of the observers on short synthetic sequences.
+ *
+ * \details
+ * Usage: goldenSequences <test configuration> <golden directory> <default configuration of the Kinetics Observer>
+ *        [record]
+ *
+ * The sequences are generated from the initial stance of the robot: the robot doesn't move, the IMUs measure the
+ * gravity and the force sensors of the supports share the weight of the robot, balanced around its center of mass.
+ * They differ by the bounded noise added to the measurements and by the unloading of a support (contact removal).
+ *
+ * Each observer is run headless on each sequence, with its own controller, through the batch loop of batchTools.h (the
+ * Kinetics Observer is preceded by the Tilt Observer it uses as backup in the same controller, as in the pipelines of
+ * the controllers). The Kinetics Observer is also run with its contacts detected from thresholds on the measured
+ * forces, so they take the kinematics of their force sensor instead of the ones of a surface. The estimation of each
+ * iteration is compared to the golden trajectory of the observer for the sequence
+ * (<golden directory>/<observer>/<sequence>.txt, in the format of goldenTools.h), which is the estimation recorded on
+ * the reference version of the observers, with tolerances close to the numerical noise. The mean duration of the
+ * iterations is reported with the golden one, so the accuracy and the speed are tracked together. The test fails if any
+ * tolerance is exceeded.
+ *
+ * With the "record" argument, the golden trajectories are written instead. They must be recorded on the reference
+ * version of the observers and committed with the test. If some are missing, the test is reported as skipped
+ * (missingGoldenCode) rather than passed.
+ *
+ * The noise is drawn from a Mersenne Twister with a fixed seed and mapped to a uniform distribution by hand, as the
+ * distributions of the standard library are implementation-defined, so the sequences are identical on all platforms.
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/AttitudeObserver.h>
+#include <mc_state_observation/MCKineticsObserver.h>
+#include <mc_state_observation/NaiveOdometry.h>
+#include <mc_state_observation/TiltObserver.h>
+#include <mc_state_observation/observersTools/batchTools.h>
+#include <mc_state_observation/observersTools/goldenTools.h>
+#include <mc_state_observation/observersTools/headlessTools.h>
+
+#include <state-observation/tools/definitions.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mcso = mc_state_observation;
+namespace so = stateObservation;
+
+namespace
+{
+
+// return code of the test when golden trajectories are missing, reported as skipped by ctest
+constexpr int missingGoldenCode = 77;
+
+/// Synthetic sequence.
+struct Sequence
+{
+  std::string name;
+  double duration = 2.0;
+  // amplitudes of the uniform noises added to the measurements
+  double gyroNoise = 0.0;
+  double acceleroNoise = 0.0;
+  double forceNoise = 0.0;
+  // support unloaded during the sequence, none if empty
+  std::string liftedSensor;
+  double liftStart = 0.0;
+  double liftDuration = 0.0;
+};
+
+/// Uniform noise in [-amplitude, amplitude], identical on all the platforms.
+class Noise
+{
+public:
+  explicit Noise(double amplitude) : amplitude_(amplitude) {}
+
+  double operator()()
+  {
+    if(amplitude_ == 0.0) { return 0.0; }
+    const double unit = static_cast<double>(engine_() - std::mt19937::min())
+                        / static_cast<double>(std::mt19937::max() - std::mt19937::min());
+    return amplitude_ * (2.0 * unit - 1.0);
+  }
+
+  /// Draws the coordinates in order (the evaluation order of the arguments of a constructor is unspecified).
+  Eigen::Vector3d vector()
+  {
+    Eigen::Vector3d res;
+    for(Eigen::Index i = 0; i < 3; i++) { res(i) = (*this)(); }
+    return res;
+  }
+
+private:
+  double amplitude_;
+  std::mt19937 engine_{42};
+};
+
+/// Estimation of an observer on a sequence.
+struct Result
+{
+  std::string observer;
+  std::string sequence;
+  double meanDuration = 0.0; // [s]
+  bool success = false;
+};
+
+Sequence loadSequence(const mc_rtc::Configuration & config)
+{
+  Sequence sequence;
+  sequence.name = static_cast<std::string>(config("name"));
+  config("duration", sequence.duration);
+  config("gyroNoise", sequence.gyroNoise);
+  config("acceleroNoise", sequence.acceleroNoise);
+  config("forceNoise", sequence.forceNoise);
+  if(config.has("lift"))
+  {
+    auto lift = config("lift");
+    sequence.liftedSensor = static_cast<std::string>(lift("sensor"));
+    lift("start", sequence.liftStart);
+    lift("duration", sequence.liftDuration);
+  }
+  return sequence;
+}
+
+/// Generates the measurements of a sequence from the initial stance of the robot.
+mcso::batchTools::InputSequence makeInputs(const mc_rbdyn::Robot & robot,
+                                           const std::vector<std::string> & supports,
+                                           const Sequence & sequence,
+                                           double dt)
+{
+  const auto nbIters = static_cast<Eigen::Index>(std::lround(sequence.duration / dt));
+  const auto & bodySensors = robot.bodySensors();
+  const auto & forceSensors = robot.forceSensors();
+  const auto nbJoints = static_cast<Eigen::Index>(robot.refJointOrder().size());
+
+  mcso::batchTools::InputSequence inputs;
+  inputs.encoders.resize(nbJoints, nbIters);
+  inputs.gyrometers.resize(3 * static_cast<Eigen::Index>(bodySensors.size()), nbIters);
+  inputs.accelerometers.resize(3 * static_cast<Eigen::Index>(bodySensors.size()), nbIters);
+  inputs.wrenches.resize(6 * static_cast<Eigen::Index>(forceSensors.size()), nbIters);
+
+  // the joints keep their initial configuration
+  Eigen::VectorXd stance(nbJoints);
+  for(Eigen::Index i = 0; i < nbJoints; i++)
+  {
+    const int mbcIndex = robot.jointIndexInMBC(static_cast<size_t>(i));
+    const auto & q = mbcIndex >= 0 ? robot.mbc().q[static_cast<size_t>(mbcIndex)] : std::vector<double>();
+    stance(i) = q.empty() ? 0.0 : q[0];
+  }
+  inputs.encoders.colwise() = stance;
+
+  // the IMUs only measure the gravity (specific force of a static body)
+  const Eigen::Vector3d specificForce(0.0, 0.0, so::cst::gravityConstant);
+  std::vector<Eigen::Vector3d> accelerations(bodySensors.size());
+  for(size_t i = 0; i < bodySensors.size(); i++)
+  {
+    const sva::PTransformd X_0_s = bodySensors[i].X_b_s() * robot.bodyPosW(bodySensors[i].parentBody());
+    accelerations[i] = X_0_s.rotation() * specificForce;
+  }
+
+  // each support carries its share of the weight and balances it around the center of mass
+  const Eigen::Vector3d com = robot.com();
+  const double weight = robot.mass() * so::cst::gravityConstant;
+  std::vector<sva::PTransformd> supportPoses;
+  std::vector<size_t> supportIndices;
+  for(const auto & support : supports)
+  {
+    const auto & fs = robot.forceSensor(support);
+    supportPoses.push_back(fs.X_p_f() * robot.bodyPosW(fs.parentBody()));
+    for(size_t i = 0; i < forceSensors.size(); i++)
+    {
+      if(forceSensors[i].name() == support) { supportIndices.push_back(i); }
+    }
+  }
+
+  Noise gyroNoise(sequence.gyroNoise);
+  Noise acceleroNoise(sequence.acceleroNoise);
+  Noise forceNoise(sequence.forceNoise);
+  inputs.wrenches.setZero();
+  for(Eigen::Index iter = 0; iter < nbIters; iter++)
+  {
+    for(size_t i = 0; i < bodySensors.size(); i++)
+    {
+      const auto row = 3 * static_cast<Eigen::Index>(i);
+      inputs.gyrometers.block<3, 1>(row, iter) = gyroNoise.vector();
+      inputs.accelerometers.block<3, 1>(row, iter) = accelerations[i] + acceleroNoise.vector();
+    }
+
+    // load of the lifted support, from 1 before the lift to 0 at its end
+    double liftedLoad = 1.0;
+    if(!sequence.liftedSensor.empty())
+    {
+      const double t = static_cast<double>(iter) * dt;
+      liftedLoad = sequence.liftDuration > 0.0 ? 1.0 - (t - sequence.liftStart) / sequence.liftDuration
+                                               : (t < sequence.liftStart ? 1.0 : 0.0);
+      liftedLoad = std::min(std::max(liftedLoad, 0.0), 1.0);
+    }
+    double totalLoad = 0.0;
+    std::vector<double> loads(supports.size(), 1.0);
+    for(size_t i = 0; i < supports.size(); i++)
+    {
+      if(supports[i] == sequence.liftedSensor) { loads[i] = liftedLoad; }
+      totalLoad += loads[i];
+    }
+
+    for(size_t i = 0; i < supports.size(); i++)
+    {
+      const sva::PTransformd & X_0_s = supportPoses[i];
+      const Eigen::Vector3d force(0.0, 0.0, weight * loads[i] / totalLoad);
+      // moment at the sensor cancelling the one of the force around the center of mass
+      const Eigen::Vector3d moment = -(X_0_s.translation() - com).cross(force);
+      const auto row = 6 * static_cast<Eigen::Index>(supportIndices[i]);
+      inputs.wrenches.block<3, 1>(row, iter) = X_0_s.rotation() * moment;
+      inputs.wrenches.block<3, 1>(row + 3, iter) = X_0_s.rotation() * force + forceNoise.vector();
+    }
+  }
+  return inputs;
+}
+
+/// Path of the golden trajectory of an observer on a sequence.
+std::string goldenFile(const std::string & goldenDirectory, const std::string & observer, const Sequence & sequence)
+{
+  return goldenDirectory + "/" + observer + "/" + sequence.name + ".txt";
+}
+
+/// Configuration of the comparison of an observer to the golden trajectory of a sequence, or of its recording.
+mc_rtc::Configuration goldenConfiguration(const std::string & goldenDirectory,
+                                          const std::string & observer,
+                                          const Sequence & sequence,
+                                          const mc_rtc::Configuration & observerConfig,
+                                          bool record)
+{
+  mc_rtc::Configuration config;
+  config.add("mode", std::string(record ? "record" : "compare"));
+  config.add("file", goldenFile(goldenDirectory, observer, sequence));
+  if(!observerConfig("tolerances").has(sequence.name))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("No tolerances given for the sequence {}", sequence.name);
+  }
+  config.add("tolerances", observerConfig("tolerances")(sequence.name));
+  config.add("relative", observerConfig("relativeTolerances", true));
+  return config;
+}
+
+/// Observers run in order at each iteration, the estimation is the one of the last observer.
+struct ObserversPipeline
+{
+  std::vector<std::unique_ptr<mc_observers::Observer>> observers;
+  std::function<void(sva::PTransformd &, sva::MotionVecd &)> estimation;
+
+  template<typename ObserverT>
+  void add(mc_control::MCController & ctl, const std::string & type, const mc_rtc::Configuration & config)
+  {
+    auto observer = mcso::headlessTools::makeObserver<ObserverT>(ctl, type, config);
+    const ObserverT * estimator = observer.get();
+    estimation = [estimator](sva::PTransformd & X, sva::MotionVecd & v)
+    {
+      X = estimator->posW();
+      v = estimator->velW();
+    };
+    observers.push_back(std::move(observer));
+  }
+};
+
+/// Runs the observers of a pipeline on a sequence through the batch loop (see batchTools.h) and compares the
+/// estimation of the last one to its golden trajectory.
+Result runPipeline(const std::string & type,
+                   const std::function<ObserversPipeline(mc_control::MCController &)> & makePipeline,
+                   const mc_rtc::Configuration & observerConfig,
+                   const std::shared_ptr<mc_rbdyn::RobotModule> & robotModule,
+                   const std::vector<std::string> & supports,
+                   const Sequence & sequence,
+                   const std::string & goldenDirectory,
+                   bool record,
+                   double dt)
+{
+  auto ctl = mcso::headlessTools::makeController(robotModule, dt);
+  ctl->robot().forwardKinematics();
+  const auto inputs = makeInputs(ctl->robot(), supports, sequence, dt);
+  ObserversPipeline pipeline = makePipeline(*ctl);
+
+  mcso::batchTools::OutputSequence outputs;
+  outputs.resize(inputs.size());
+  std::vector<double> durations(static_cast<size_t>(inputs.size()));
+  size_t iter = 0;
+  mcso::batchTools::OutputView outputsView(outputs);
+  mcso::batchTools::runBatch(*ctl, ctl->robot().name(), mcso::batchTools::InputView(inputs), outputsView, type,
+                             [&](sva::PTransformd & X, sva::MotionVecd & v)
+                             {
+                               const auto start = std::chrono::steady_clock::now();
+                               for(auto & observer : pipeline.observers) { observer->run(*ctl); }
+                               durations[iter++] =
+                                   std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                               pipeline.estimation(X, v);
+                             });
+
+  Result result{type, sequence.name, 0.0, false};
+  mcso::goldenTools::GoldenTrajectory golden;
+  golden.configure(goldenConfiguration(goldenDirectory, type, sequence, observerConfig, record),
+                   type + "/" + sequence.name);
+  for(Eigen::Index i = 0; i < outputs.size(); i++)
+  {
+    const Eigen::Quaterniond q(outputs.orientations.col(i));
+    // the quaternions of the outputs are the ones of the orientation matrices, transposed in SpaceVecAlg
+    const sva::PTransformd X(Eigen::Matrix3d(q.toRotationMatrix().transpose()), outputs.positions.col(i));
+    const double duration = durations[static_cast<size_t>(i)];
+    golden.add(X, sva::MotionVecd(outputs.angVels.col(i), outputs.linVels.col(i)), duration);
+    result.meanDuration += duration / static_cast<double>(outputs.size());
+  }
+  result.success = golden.finish();
+  return result;
+}
+
+/// Runs the attitude observer, estimating the orientation of an IMU, on a sequence.
+Result runAttitudeObserver(const mc_rtc::Configuration & observerConfig,
+                           const std::shared_ptr<mc_rbdyn::RobotModule> & robotModule,
+                           const std::vector<std::string> & supports,
+                           const Sequence & sequence,
+                           const std::string & goldenDirectory,
+                           bool record,
+                           double dt)
+{
+  const std::string type = "AttitudeObserver";
+  auto ctl = mcso::headlessTools::makeController(robotModule, dt);
+  ctl->robot().forwardKinematics();
+  const auto inputs = makeInputs(ctl->robot(), supports, sequence, dt);
+  auto observer = mcso::headlessTools::makeObserver<mcso::AttitudeObserver>(*ctl, type, observerConfig("config"));
+
+  const auto & robot = ctl->robot();
+  const std::string imuSensor = observerConfig("config")("imuSensor", robot.bodySensor().name());
+
+  Result result{type, sequence.name, 0.0, false};
+  mcso::goldenTools::GoldenTrajectory golden;
+  golden.configure(goldenConfiguration(goldenDirectory, type, sequence, observerConfig, record),
+                   type + "/" + sequence.name);
+  mcso::batchTools::InputsWriter writer(*ctl, robot.name(), inputs, type);
+  for(Eigen::Index iter = 0; iter < inputs.size(); iter++)
+  {
+    writer.write(iter);
+    const auto start = std::chrono::steady_clock::now();
+    observer->run(*ctl);
+    const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.meanDuration += duration / static_cast<double>(inputs.size());
+
+    // the attitude observer only estimates the orientation of the IMU, written in the sensor
+    observer->update(*ctl);
+    const Eigen::Matrix3d orientation = ctl->robot().bodySensor(imuSensor).orientation().toRotationMatrix();
+    golden.add(sva::PTransformd(orientation, Eigen::Vector3d::Zero()), sva::MotionVecd::Zero(), duration);
+  }
+  result.success = golden.finish();
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  const bool record = argc == 5 && std::string(argv[4]) == "record";
+  if(argc != 4 && !record)
+  {
+    mc_rtc::log::error(
+        "Usage: {} <test configuration> <golden directory> <default configuration of the Kinetics Observer> [record]",
+        argv[0]);
+    return 1;
+  }
+  const std::string goldenDirectory = argv[2];
+  const std::vector<std::string> observerTypes = {"MCKineticsObserver", "MCKineticsObserverFromThreshold",
+                                                  "TiltObserver", "NaiveOdometry", "AttitudeObserver"};
+
+  std::vector<Result> results;
+  try
+  {
+    const mc_rtc::Configuration config(argv[1]);
+    const double dt = config("dt");
+    const std::vector<std::string> robot = config("robot");
+    const auto robotModule = mc_rbdyn::RobotLoader::get_robot_module(robot);
+    const std::vector<std::string> supports = config("supports");
+
+    std::vector<Sequence> sequences;
+    const std::vector<mc_rtc::Configuration> sequencesConfig = config("sequences");
+    for(const auto & sequenceConfig : sequencesConfig) { sequences.push_back(loadSequence(sequenceConfig)); }
+
+    // the golden trajectories are recorded on the reference version of the observers, never by a comparison
+    std::string missingGoldens;
+    for(const auto & sequence : sequences)
+    {
+      for(const auto & type : observerTypes)
+      {
+        const std::string file = goldenFile(goldenDirectory, type, sequence);
+        if(record) { std::filesystem::create_directories(std::filesystem::path(file).parent_path()); }
+        else if(!std::filesystem::exists(file)) { missingGoldens += (missingGoldens.empty() ? "" : ", ") + file; }
+      }
+    }
+    if(!missingGoldens.empty())
+    {
+      mc_rtc::log::error("Missing golden trajectories: {}. Record them on the reference version of the observers with "
+                         "the record argument.",
+                         missingGoldens);
+      return missingGoldenCode;
+    }
+
+    const auto observers = config("observers");
+    // the configuration of the Kinetics Observer completes the default one
+    mc_rtc::Configuration koDefaultConfig(argv[3]);
+    koDefaultConfig.load(observers("MCKineticsObserver")("config"));
+    mc_rtc::Configuration koConfig;
+    koConfig.add("config", koDefaultConfig);
+    koConfig.add("tolerances", observers("MCKineticsObserver")("tolerances"));
+    // the variant with the contacts detected from thresholds completes the configuration of the Kinetics Observer
+    mc_rtc::Configuration koThresholdDefaultConfig;
+    koThresholdDefaultConfig.load(koDefaultConfig);
+    koThresholdDefaultConfig.load(observers("MCKineticsObserverFromThreshold")("config"));
+    mc_rtc::Configuration koThresholdConfig;
+    koThresholdConfig.add("config", koThresholdDefaultConfig);
+    koThresholdConfig.add("tolerances", observers("MCKineticsObserverFromThreshold")("tolerances"));
+    // the Kinetics Observer uses the Tilt Observer of the same controller as backup
+    mc_rtc::Configuration tiltBackupConfig;
+    tiltBackupConfig.load(observers("TiltObserver")("config"));
+    tiltBackupConfig.add("asBackup", true);
+    const mc_rtc::Configuration tiltConfig = observers("TiltObserver")("config");
+    const mc_rtc::Configuration naiveConfig = observers("NaiveOdometry")("config");
+
+    for(const auto & sequence : sequences)
+    {
+      results.push_back(runPipeline(
+          "MCKineticsObserver",
+          [&](mc_control::MCController & ctl)
+          {
+            ObserversPipeline pipeline;
+            pipeline.add<mcso::TiltObserver>(ctl, "TiltObserver", tiltBackupConfig);
+            pipeline.add<mcso::MCKineticsObserver>(ctl, "MCKineticsObserver", koConfig("config"));
+            return pipeline;
+          },
+          koConfig, robotModule, supports, sequence, goldenDirectory, record, dt));
+      results.push_back(runPipeline(
+          "MCKineticsObserverFromThreshold",
+          [&](mc_control::MCController & ctl)
+          {
+            ObserversPipeline pipeline;
+            pipeline.add<mcso::TiltObserver>(ctl, "TiltObserver", tiltBackupConfig);
+            pipeline.add<mcso::MCKineticsObserver>(ctl, "MCKineticsObserver", koThresholdConfig("config"));
+            return pipeline;
+          },
+          koThresholdConfig, robotModule, supports, sequence, goldenDirectory, record, dt));
+      results.push_back(runPipeline(
+          "TiltObserver",
+          [&](mc_control::MCController & ctl)
+          {
+            ObserversPipeline pipeline;
+            pipeline.add<mcso::TiltObserver>(ctl, "TiltObserver", tiltConfig);
+            return pipeline;
+          },
+          observers("TiltObserver"), robotModule, supports, sequence, goldenDirectory, record, dt));
+      results.push_back(runPipeline(
+          "NaiveOdometry",
+          [&](mc_control::MCController & ctl)
+          {
+            ObserversPipeline pipeline;
+            pipeline.add<mcso::NaiveOdometry>(ctl, "NaiveOdometry", naiveConfig);
+            return pipeline;
+          },
+          observers("NaiveOdometry"), robotModule, supports, sequence, goldenDirectory, record, dt));
+      results.push_back(runAttitudeObserver(observers("AttitudeObserver"), robotModule, supports, sequence,
+                                            goldenDirectory, record, dt));
+    }
+  }
+  catch(const std::exception & e)
+  {
+    mc_rtc::log::error("The golden sequences could not be run: {}", e.what());
+    return 1;
+  }
+
+  size_t failures = 0;
+  mc_rtc::log::info("{:<20} {:<15} {:>12}  result", "observer", "sequence", "us/iteration");
+  for(const auto & result : results)
+  {
+    mc_rtc::log::info("{:<20} {:<15} {:>12.1f}  {}", result.observer, result.sequence, result.meanDuration * 1e6,
+                      result.success ? (record ? "recorded" : "ok") : "FAILED");
+    if(!result.success) { ++failures; }
+  }
+  if(failures > 0)
+  {
+    mc_rtc::log::error("{} of the {} estimations differ from the golden trajectories or could not be recorded",
+                       failures, results.size());
+    return 1;
+  }
+  if(record) { mc_rtc::log::success("The {} golden trajectories are recorded in {}", results.size(), goldenDirectory); }
+  else { mc_rtc::log::success("All the {} estimations match the golden trajectories", results.size()); }
+  return 0;
+}